@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Helpers shared by the cross-module benchmarks in this directory. Targets
+// that report allocations must also link `counting_new.cpp`.
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the compiler from discarding a value or hoisting work out of a loop
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+// Number of `operator new` calls so far, see `counting_new.cpp`
+size_t AllocationCount();
+
+struct Result {
+    std::string group;
+    std::string name;
+    double ns_per_op = 0;
+    double allocations_per_op = 0;
+};
+
+// Best of `repetitions` runs of `iterations` calls of `op`. Taking the minimum
+// filters out interference from the rest of the machine.
+template <typename Op>
+Result Measure(std::string group, std::string name, size_t iterations, Op op,
+               int repetitions = 5) {
+    Result result{std::move(group), std::move(name)};
+    result.ns_per_op = 1e300;
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+        size_t allocations = AllocationCount();
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            op();
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        result.ns_per_op = std::min(result.ns_per_op, elapsed / iterations);
+        result.allocations_per_op =
+            static_cast<double>(AllocationCount() - allocations) / iterations;
+    }
+    return result;
+}
+
+inline void PrintTable(const std::vector<Result>& results) {
+    std::printf("%-28s %-26s %10s %12s\n", "", "", "ns/op", "allocs/op");
+    for (const auto& result : results) {
+        std::printf("%-28s %-26s %10.2f %12.2f\n", result.group.c_str(), result.name.c_str(),
+                    result.ns_per_op, result.allocations_per_op);
+    }
+}
+
+// Flat JSON array, one object per result, for regression tracking scripts
+inline void WriteJson(const std::vector<Result>& results, std::FILE* out) {
+    std::fprintf(out, "[\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        std::fprintf(out,
+                     "  {\"group\": \"%s\", \"name\": \"%s\", \"ns_per_op\": %.3f, "
+                     "\"allocations_per_op\": %.3f}%s\n",
+                     result.group.c_str(), result.name.c_str(), result.ns_per_op,
+                     result.allocations_per_op, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "]\n");
+}
+
+// `--json` writes JSON to stdout instead of the table, `--json=<path>` writes
+// it to a file in addition to the table
+inline bool Report(const std::vector<Result>& results, int argc, char** argv) {
+    std::string json_path;
+    bool json_only = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            json_only = true;
+        } else if (arg.rfind("--json=", 0) == 0) {
+            json_path = arg.substr(7);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--json | --json=<path>]\n", argv[0]);
+            return false;
+        }
+    }
+    if (json_only) {
+        WriteJson(results, stdout);
+        return true;
+    }
+    PrintTable(results);
+    if (!json_path.empty()) {
+        std::FILE* out = std::fopen(json_path.c_str(), "w");
+        if (!out) {
+            std::perror(json_path.c_str());
+            return false;
+        }
+        WriteJson(results, out);
+        std::fclose(out);
+    }
+    return true;
+}
+
+}  // namespace bench
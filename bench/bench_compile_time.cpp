@@ -0,0 +1,174 @@
+#include "bench.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Build cost of the pointer templates. Compiles `compile_time_unit.cpp`, which
+// instantiates `CompressedPair<F, S>`, `UniquePtr<T, D>`, `SharedPtr<T>` and
+// `MakeShared<T>` for a thousand distinct types each (`--types=<n>`), with the
+// compiler this target was built with.
+// Each workload is timed twice: front end only (`-fsyntax-only`, i.e. parsing
+// and template instantiation) and a full `-O2 -c`, whose object size is
+// reported too. Per type numbers are over the headers-only baseline.
+
+#ifndef COMPILE_TIME_CXX
+#define COMPILE_TIME_CXX "c++"
+#endif
+
+#ifndef COMPILE_TIME_SOURCE_DIR
+#define COMPILE_TIME_SOURCE_DIR "."
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using bench::Clock;
+
+struct Workload {
+    const char* name;
+    const char* defines;
+};
+
+constexpr Workload kWorkloads[] = {
+    {"headers only", ""},
+    {"CompressedPair<F, S>", "-DCOMPILE_TIME_COMPRESSED_PAIR"},
+    {"UniquePtr<T, D>", "-DCOMPILE_TIME_UNIQUE"},
+    {"SharedPtr<T>", "-DCOMPILE_TIME_SHARED"},
+    {"MakeShared<T>", "-DCOMPILE_TIME_MAKE_SHARED"},
+    {"all", "-DCOMPILE_TIME_COMPRESSED_PAIR -DCOMPILE_TIME_UNIQUE -DCOMPILE_TIME_SHARED "
+            "-DCOMPILE_TIME_MAKE_SHARED"},
+};
+
+struct Options {
+    std::string compiler = COMPILE_TIME_CXX;
+    size_t types = 1000;
+    int repetitions = 3;
+    bool json = false;
+};
+
+struct Sample {
+    std::string workload;
+    double front_end_seconds = 0;
+    double compile_seconds = 0;
+    uintmax_t object_bytes = 0;
+};
+
+// Best of `repetitions`, or a negative time if the compiler failed
+double TimeCommand(const std::string& command, int repetitions) {
+    double best = 1e300;
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+        auto start = Clock::now();
+        if (std::system(command.c_str()) != 0) {
+            std::fprintf(stderr, "Failed: %s\n", command.c_str());
+            return -1;
+        }
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+bool Run(const Options& options, const Workload& workload, const fs::path& object,
+         Sample* sample) {
+    std::string command = options.compiler + " -std=c++20 -I" COMPILE_TIME_SOURCE_DIR +
+                          " -DCOMPILE_TIME_TYPES=" + std::to_string(options.types) + " " +
+                          workload.defines + " " COMPILE_TIME_SOURCE_DIR
+                          "/bench/compile_time_unit.cpp";
+    sample->workload = workload.name;
+    sample->front_end_seconds = TimeCommand(command + " -fsyntax-only", options.repetitions);
+    sample->compile_seconds =
+        TimeCommand(command + " -O2 -c -o " + object.string(), options.repetitions);
+    if (sample->front_end_seconds < 0 || sample->compile_seconds < 0) {
+        return false;
+    }
+    sample->object_bytes = fs::file_size(object);
+    return true;
+}
+
+void PrintTable(const Options& options, const std::vector<Sample>& samples) {
+    std::printf("%zu types, %s\n", options.types, options.compiler.c_str());
+    std::printf("%-22s %12s %12s %14s %14s %12s\n", "", "front end, s", "-O2 -c, s",
+                "front end/type", "-O2 -c/type", "object, KiB");
+    const auto& base = samples.front();
+    for (const auto& sample : samples) {
+        std::printf("%-22s %12.3f %12.3f", sample.workload.c_str(), sample.front_end_seconds,
+                    sample.compile_seconds);
+        if (&sample == &base) {
+            std::printf(" %14s %14s", "", "");
+        } else {
+            std::printf(" %11.1f us %11.1f us",
+                        (sample.front_end_seconds - base.front_end_seconds) * 1e6 / options.types,
+                        (sample.compile_seconds - base.compile_seconds) * 1e6 / options.types);
+        }
+        std::printf(" %12.1f\n", sample.object_bytes / 1024.0);
+    }
+}
+
+void PrintJson(const Options& options, const std::vector<Sample>& samples) {
+    std::printf("[\n");
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto& sample = samples[i];
+        std::printf("  {\"workload\": \"%s\", \"types\": %zu, \"front_end_seconds\": %.3f, "
+                    "\"compile_seconds\": %.3f, \"object_bytes\": %ju}%s\n",
+                    sample.workload.c_str(), options.types, sample.front_end_seconds,
+                    sample.compile_seconds, sample.object_bytes,
+                    i + 1 < samples.size() ? "," : "");
+    }
+    std::printf("]\n");
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            options->json = true;
+        } else if (arg.rfind("--types=", 0) == 0) {
+            options->types = std::stoul(arg.substr(8));
+        } else if (arg.rfind("--repetitions=", 0) == 0) {
+            options->repetitions = std::stoi(arg.substr(14));
+        } else if (arg.rfind("--cxx=", 0) == 0) {
+            options->compiler = arg.substr(6);
+        } else {
+            std::fprintf(stderr,
+                         "Usage: %s [--types=<n>] [--repetitions=<n>] [--cxx=<compiler>] "
+                         "[--json]\n",
+                         argv[0]);
+            return false;
+        }
+    }
+    return options->types > 0 && options->repetitions > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        return 1;
+    }
+    auto object = fs::temp_directory_path() /
+                  ("bench_compile_time_" + std::to_string(getpid()) + ".o");
+    std::vector<Sample> samples;
+    bool ok = true;
+    for (const auto& workload : kWorkloads) {
+        if (!Run(options, workload, object, &samples.emplace_back())) {
+            ok = false;
+            break;
+        }
+    }
+    fs::remove(object);
+    if (!ok) {
+        return 1;
+    }
+    if (options.json) {
+        PrintJson(options, samples);
+    } else {
+        PrintTable(options, samples);
+    }
+    return 0;
+}
@@ -0,0 +1,350 @@
+#include "bench.h"
+
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+#include <shared-from-this/weak.h>
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/resource.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Workloads shaped like real users of the library, to catch what the
+// microbenchmarks miss: allocation locality, cascades of destructors, weak
+// references outliving their objects. Each reports throughput, p50/p99
+// latency of one unit of work and the process' peak RSS so far. Run a single
+// workload (`--workload=<name>`) to get a peak RSS that belongs to it alone.
+
+namespace {
+
+using bench::Clock;
+
+struct Latencies {
+    std::vector<double> samples;  // microseconds
+
+    template <typename Op>
+    void Time(Op op) {
+        auto start = Clock::now();
+        op();
+        samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    double Percentile(double fraction) {
+        std::sort(samples.begin(), samples.end());
+        return samples[static_cast<size_t>(fraction * (samples.size() - 1))];
+    }
+};
+
+struct Report {
+    std::string workload;
+    std::string unit;
+    size_t operations;
+    double operations_per_second;
+    double p50_us;
+    double p99_us;
+    long peak_rss_kb;
+};
+
+long PeakRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template <typename Setup, typename Op>
+Report Run(std::string workload, std::string unit, size_t operations, Setup setup, Op op) {
+    auto state = setup();
+    Latencies latencies;
+    latencies.samples.reserve(operations);
+    auto start = Clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+        latencies.Time([&] { op(state, i); });
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return {std::move(workload),       std::move(unit),           operations,
+            operations / seconds,      latencies.Percentile(0.5), latencies.Percentile(0.99),
+            PeakRssKb()};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// LRU cache of `SharedPtr` values. Readers keep `WeakPtr` observers to values
+// they saw and check them later; evicted values die once nobody holds them.
+
+struct CachedValue {
+    explicit CachedValue(int key) : key(key), payload(64 + key % 192, 'x') {
+    }
+    int key;
+    std::string payload;
+};
+
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : capacity_(capacity) {
+    }
+
+    SharedPtr<CachedValue> Get(int key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    void Put(int key, SharedPtr<CachedValue> value) {
+        entries_.emplace_front(key, std::move(value));
+        index_[key] = entries_.begin();
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+private:
+    using Entry = std::pair<int, SharedPtr<CachedValue>>;
+
+    size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_map<int, std::list<Entry>::iterator> index_;
+};
+
+struct LruState {
+    LruCache cache{10'000};
+    std::vector<WeakPtr<CachedValue>> observers{4096};
+    std::mt19937 gen{1};
+    size_t hits = 0;
+};
+
+// One request: look the key up, load it on a miss, remember it in an
+// observer slot and probe another observer
+void LruRequest(LruState& state, size_t) {
+    std::uniform_real_distribution<double> uniform;
+    // Skewed popularity: low keys are hot
+    int key = static_cast<int>(100'000 * std::pow(uniform(state.gen), 3));
+    auto value = state.cache.Get(key);
+    if (!value) {
+        value = MakeShared<CachedValue>(key);
+        state.cache.Put(key, value);
+    }
+    state.observers[state.gen() % state.observers.size()] = WeakPtr<CachedValue>(value);
+    auto& probe = state.observers[state.gen() % state.observers.size()];
+    if (!probe.Expired()) {
+        state.hits += probe.Lock()->payload.size() > 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scene graph of `IntrusivePtr` nodes. Each frame recomputes world positions
+// and replaces one branch, so a subtree of ~1400 nodes is destroyed in one
+// cascade and rebuilt node by node.
+
+struct Node : SimpleRefCounted<Node> {
+    float local[3] = {};
+    float world[3] = {};
+    std::vector<IntrusivePtr<Node>> children;
+};
+
+IntrusivePtr<Node> BuildBranch(std::mt19937& gen, int depth) {
+    auto node = MakeIntrusive<Node>();
+    for (float& coordinate : node->local) {
+        coordinate = static_cast<float>(gen() % 100) / 10;
+    }
+    if (depth > 0) {
+        for (int i = 0; i < 4; ++i) {
+            node->children.push_back(BuildBranch(gen, depth - 1));
+        }
+    }
+    return node;
+}
+
+void UpdateWorld(Node* node, const float* parent) {
+    for (int i = 0; i < 3; ++i) {
+        node->world[i] = parent[i] + node->local[i];
+    }
+    for (const auto& child : node->children) {
+        UpdateWorld(child.Get(), node->world);
+    }
+}
+
+struct SceneState {
+    IntrusivePtr<Node> root = MakeIntrusive<Node>();
+    std::mt19937 gen{2};
+};
+
+SceneState BuildScene() {
+    SceneState state;
+    for (int i = 0; i < 64; ++i) {
+        state.root->children.push_back(BuildBranch(state.gen, 5));
+    }
+    return state;
+}
+
+void SceneFrame(SceneState& state, size_t) {
+    const float origin[3] = {};
+    UpdateWorld(state.root.Get(), origin);
+    auto& branch = state.root->children[state.gen() % state.root->children.size()];
+    branch = BuildBranch(state.gen, 5);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// DAG executor. A task that finishes decrements its dependents, and the last
+// dependency to finish schedules the dependent, which enqueues itself with
+// `SharedFromThis()`. One operation builds, runs and tears down a DAG.
+
+class Executor;
+
+class Task : public EnableSharedFromThis<Task> {
+public:
+    Task(Executor* executor, int id) : executor_(executor), id_(id) {
+    }
+
+    void DependOn(Task& other) {
+        ++pending_;
+        other.dependents_.push_back(SharedFromThis());
+    }
+
+    void Schedule();
+
+    void Run(long& checksum) {
+        checksum += id_;
+        for (const auto& dependent : dependents_) {
+            if (--dependent->pending_ == 0) {
+                dependent->Schedule();
+            }
+        }
+    }
+
+    int Pending() const {
+        return pending_;
+    }
+
+private:
+    Executor* executor_;
+    int id_;
+    int pending_ = 0;
+    std::vector<SharedPtr<Task>> dependents_;
+};
+
+class Executor {
+public:
+    void Enqueue(SharedPtr<Task> task) {
+        ready_.push_back(std::move(task));
+    }
+
+    long RunAll() {
+        long checksum = 0;
+        while (!ready_.empty()) {
+            auto task = std::move(ready_.back());
+            ready_.pop_back();
+            task->Run(checksum);
+        }
+        return checksum;
+    }
+
+private:
+    std::vector<SharedPtr<Task>> ready_;
+};
+
+void Task::Schedule() {
+    executor_->Enqueue(SharedFromThis());
+}
+
+struct DagState {
+    std::mt19937 gen{3};
+    long checksum = 0;
+};
+
+// 20 layers of 100 tasks, each depending on up to 3 tasks of the layer before
+void DagRun(DagState& state, size_t) {
+    constexpr int kLayers = 20;
+    constexpr int kWidth = 100;
+    Executor executor;
+    std::vector<SharedPtr<Task>> tasks;
+    tasks.reserve(kLayers * kWidth);
+    for (int layer = 0; layer < kLayers; ++layer) {
+        for (int i = 0; i < kWidth; ++i) {
+            auto task = MakeShared<Task>(&executor, layer * kWidth + i);
+            if (layer > 0) {
+                int dependencies = 1 + state.gen() % 3;
+                for (int d = 0; d < dependencies; ++d) {
+                    task->DependOn(*tasks[(layer - 1) * kWidth + state.gen() % kWidth]);
+                }
+            }
+            tasks.push_back(std::move(task));
+        }
+    }
+    for (const auto& task : tasks) {
+        if (task->Pending() == 0) {
+            task->Schedule();
+        }
+    }
+    state.checksum += executor.RunAll();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PrintTable(const std::vector<Report>& reports) {
+    std::printf("%-12s %-10s %10s %12s %10s %10s %14s\n", "workload", "unit", "ops", "ops/s",
+                "p50 us", "p99 us", "peak RSS KiB");
+    for (const auto& r : reports) {
+        std::printf("%-12s %-10s %10zu %12.0f %10.2f %10.2f %14ld\n", r.workload.c_str(),
+                    r.unit.c_str(), r.operations, r.operations_per_second, r.p50_us, r.p99_us,
+                    r.peak_rss_kb);
+    }
+}
+
+void WriteJson(const std::vector<Report>& reports) {
+    std::printf("[\n");
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const auto& r = reports[i];
+        std::printf("  {\"workload\": \"%s\", \"unit\": \"%s\", \"operations\": %zu, "
+                    "\"operations_per_second\": %.1f, \"p50_us\": %.3f, \"p99_us\": %.3f, "
+                    "\"peak_rss_kb\": %ld}%s\n",
+                    r.workload.c_str(), r.unit.c_str(), r.operations, r.operations_per_second,
+                    r.p50_us, r.p99_us, r.peak_rss_kb, i + 1 < reports.size() ? "," : "");
+    }
+    std::printf("]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bool json = false;
+    std::string only;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg.rfind("--workload=", 0) == 0) {
+            only = arg.substr(11);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--json] [--workload=lru|scene|dag]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Report> reports;
+    if (only.empty() || only == "lru") {
+        reports.push_back(
+            Run("lru", "request", 1'000'000, [] { return LruState(); }, LruRequest));
+    }
+    if (only.empty() || only == "scene") {
+        reports.push_back(Run("scene", "frame", 500, BuildScene, SceneFrame));
+    }
+    if (only.empty() || only == "dag") {
+        reports.push_back(Run("dag", "dag run", 2'000, [] { return DagState(); }, DagRun));
+    }
+
+    if (json) {
+        WriteJson(reports);
+    } else {
+        PrintTable(reports);
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "bench.h"
+
+#include <common/profiling.h>
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Cost of the reference count profiler. Built twice from this file:
+// `bench_profiler` with SMART_POINTERS_PROFILING and `bench_profiler_baseline`
+// without it; compare the ns/op of the two.
+
+namespace {
+
+constexpr size_t kIterations = 20'000'000;
+
+struct AtomicPayload : AtomicRefCounted<AtomicPayload> {};
+
+struct SimplePayload : SimpleRefCounted<SimplePayload> {};
+
+struct SharedPayload {
+    int value = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* mode = profiling::kEnabled ? "profiled, 1/1000" : "baseline";
+    auto atomic = MakeIntrusive<AtomicPayload>();
+    auto simple = MakeIntrusive<SimplePayload>();
+    auto shared = MakeShared<SharedPayload>();
+
+    std::vector<bench::Result> results;
+    results.push_back(bench::Measure("IntrusivePtr<Atomic> copy", mode, kIterations, [&] {
+        IntrusivePtr<AtomicPayload> copy(atomic);
+        bench::DoNotOptimize(copy);
+    }));
+    results.push_back(bench::Measure("IntrusivePtr<Simple> copy", mode, kIterations, [&] {
+        IntrusivePtr<SimplePayload> copy(simple);
+        bench::DoNotOptimize(copy);
+    }));
+    results.push_back(bench::Measure("SharedPtr copy", mode, kIterations, [&] {
+        SharedPtr<SharedPayload> copy(shared);
+        bench::DoNotOptimize(copy);
+    }));
+    return bench::Report(results, argc, argv) ? 0 : 1;
+}
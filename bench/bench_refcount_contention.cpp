@@ -0,0 +1,262 @@
+#include "bench.h"
+
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+#include <shared-from-this/weak.h>
+
+#include <barrier>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copy + destroy loops from 1..N pinned threads, either all on one object
+// ("shared": every op bounces the counter's cache line between cores) or on
+// one object per thread ("per-thread": no sharing, shows the uncontended cost
+// and any false sharing). Reports throughput and, where `perf_event_open` is
+// permitted, cache misses per op.
+//
+// `SharedPtr` control blocks and `SimpleCounter` are not thread-safe, so they
+// only run per-thread; sharing them between threads would be a data race.
+
+namespace {
+
+constexpr size_t kIterations = 2'000'000;
+
+struct SharedPayload : EnableSharedFromThis<SharedPayload> {
+    int value = 0;
+};
+
+struct SimplePayload : SimpleRefCounted<SimplePayload> {
+    int value = 0;
+};
+
+struct AtomicPayload : AtomicRefCounted<AtomicPayload> {
+    int value = 0;
+};
+
+struct StdPayload {
+    int value = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hardware counters
+
+// Counts cache misses of the calling thread, if the kernel lets us
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    ~CacheMissCounter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    void Start() {
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    // Empty if counters are unavailable (no PMU, VM, perf_event_paranoid)
+    std::optional<uint64_t> Stop() {
+        if (fd_ < 0) {
+            return std::nullopt;
+        }
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t count;
+        if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+            return std::nullopt;
+        }
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// Pins the calling thread to the `index`-th CPU it may run on, wrapping
+// around. Leaves it alone if the allowed set cannot be read.
+void PinToCpu(size_t index) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return;
+    }
+    int count = CPU_COUNT(&allowed);
+    if (count == 0) {
+        return;
+    }
+    size_t skip = index % static_cast<size_t>(count);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed) && skip-- == 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            return;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct Point {
+    std::string strategy;
+    std::string mode;
+    size_t threads;
+    double mops_per_second;
+    std::optional<double> cache_misses_per_op;
+};
+
+// `make` creates the object, `shared` says whether all threads use one
+template <typename Make>
+Point Run(const char* strategy, bool shared, size_t threads, Make make) {
+    using Ptr = decltype(make());
+    std::optional<Ptr> common;
+    if (shared) {
+        common.emplace(make());
+    }
+
+    // Timestamps are taken by the barriers' completion steps, which run
+    // before any thread is released, so no worker can start early
+    bench::Clock::time_point begin;
+    bench::Clock::time_point end;
+    std::barrier start(threads + 1, [&]() noexcept { begin = bench::Clock::now(); });
+    std::barrier finish(threads + 1, [&]() noexcept { end = bench::Clock::now(); });
+    std::vector<std::optional<uint64_t>> misses(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            PinToCpu(t);
+            // Allocated by the thread that uses it, as a real owner would
+            Ptr own = shared ? *common : make();
+            CacheMissCounter counter;
+            start.arrive_and_wait();
+            counter.Start();
+            for (size_t i = 0; i < kIterations; ++i) {
+                Ptr copy(own);
+                bench::DoNotOptimize(copy);
+            }
+            misses[t] = counter.Stop();
+            finish.arrive_and_wait();
+        });
+    }
+
+    start.arrive_and_wait();
+    finish.arrive_and_wait();
+    auto elapsed = std::chrono::duration<double>(end - begin).count();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    Point point{strategy, shared ? "shared" : "per-thread", threads,
+                threads * kIterations / elapsed / 1e6, std::nullopt};
+    uint64_t total_misses = 0;
+    for (const auto& count : misses) {
+        if (!count) {
+            return point;
+        }
+        total_misses += *count;
+    }
+    point.cache_misses_per_op = static_cast<double>(total_misses) / (threads * kIterations);
+    return point;
+}
+
+void PrintTable(const std::vector<Point>& points) {
+    std::printf("%-28s %-11s %8s %10s %16s\n", "", "", "threads", "Mops/s", "cache misses/op");
+    for (const auto& point : points) {
+        std::printf("%-28s %-11s %8zu %10.2f ", point.strategy.c_str(), point.mode.c_str(),
+                    point.threads, point.mops_per_second);
+        if (point.cache_misses_per_op) {
+            std::printf("%16.3f\n", *point.cache_misses_per_op);
+        } else {
+            std::printf("%16s\n", "n/a");
+        }
+    }
+}
+
+void WriteJson(const std::vector<Point>& points, std::FILE* out) {
+    std::fprintf(out, "[\n");
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto& point = points[i];
+        std::fprintf(out,
+                     "  {\"strategy\": \"%s\", \"mode\": \"%s\", \"threads\": %zu, "
+                     "\"mops_per_second\": %.3f, \"cache_misses_per_op\": ",
+                     point.strategy.c_str(), point.mode.c_str(), point.threads,
+                     point.mops_per_second);
+        if (point.cache_misses_per_op) {
+            std::fprintf(out, "%.4f", *point.cache_misses_per_op);
+        } else {
+            std::fprintf(out, "null");
+        }
+        std::fprintf(out, "}%s\n", i + 1 < points.size() ? "," : "");
+    }
+    std::fprintf(out, "]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t max_threads = std::max(4u, std::thread::hardware_concurrency());
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            max_threads = std::strtoul(arg.c_str() + 10, nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--json] [--threads=<max>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    auto make_shared_ptr = [] { return MakeShared<SharedPayload>(); };
+    auto make_simple = [] { return MakeIntrusive<SimplePayload>(); };
+    auto make_atomic = [] { return MakeIntrusive<AtomicPayload>(); };
+    auto make_std = [] { return std::make_shared<StdPayload>(); };
+
+    std::vector<Point> points;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        points.push_back(Run("SharedPtr", false, threads, make_shared_ptr));
+        points.push_back(Run("IntrusivePtr<SimpleCounter>", false, threads, make_simple));
+        points.push_back(Run("IntrusivePtr<AtomicCounter>", false, threads, make_atomic));
+        points.push_back(Run("IntrusivePtr<AtomicCounter>", true, threads, make_atomic));
+        points.push_back(Run("std::shared_ptr", false, threads, make_std));
+        points.push_back(Run("std::shared_ptr", true, threads, make_std));
+    }
+
+    if (json) {
+        WriteJson(points, stdout);
+    } else {
+        PrintTable(points);
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include "bench.h"
+
+#include <intrusive/intrusive.h>
+#include <unique/unique.h>
+#include <weak/shared.h>
+#include <weak/weak.h>
+
+#include <memory>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Every pointer type against its standard library counterpart: ns/op and heap
+// allocations per op. `IntrusivePtr` is compared with a minimal
+// `boost::intrusive_ptr` lookalike (free `add_ref`/`release` functions found by
+// ADL, non-atomic count) so the suite has no dependency on Boost.
+//
+// Note that `SharedPtr` counts references non-atomically while
+// `std::shared_ptr` uses atomics whenever the program may be multithreaded.
+
+namespace {
+
+constexpr size_t kIterations = 2'000'000;
+
+struct Payload {
+    explicit Payload(int value) : value(value) {
+    }
+    int value;
+    int padding[3] = {};
+};
+
+struct IntrusivePayload : SimpleRefCounted<IntrusivePayload> {
+    explicit IntrusivePayload(int value) : value(value) {
+    }
+    int value;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Boost-style baseline
+
+struct BoostStylePayload {
+    explicit BoostStylePayload(int value) : value(value) {
+    }
+    int refs = 0;
+    int value;
+};
+
+void IntrusivePtrAddRef(BoostStylePayload* p) {
+    ++p->refs;
+}
+
+void IntrusivePtrRelease(BoostStylePayload* p) {
+    if (--p->refs == 0) {
+        delete p;
+    }
+}
+
+template <typename T>
+class BoostStylePtr {
+public:
+    BoostStylePtr() = default;
+
+    explicit BoostStylePtr(T* p) : p_(p) {
+        if (p_) {
+            IntrusivePtrAddRef(p_);
+        }
+    }
+
+    BoostStylePtr(const BoostStylePtr& other) : BoostStylePtr(other.p_) {
+    }
+
+    BoostStylePtr(BoostStylePtr&& other) noexcept : p_(std::exchange(other.p_, nullptr)) {
+    }
+
+    BoostStylePtr& operator=(BoostStylePtr other) noexcept {
+        std::swap(p_, other.p_);
+        return *this;
+    }
+
+    ~BoostStylePtr() {
+        if (p_) {
+            IntrusivePtrRelease(p_);
+        }
+    }
+
+    T* get() const {
+        return p_;
+    }
+
+private:
+    T* p_ = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using bench::DoNotOptimize;
+using bench::Measure;
+using bench::Result;
+
+void UniqueBenchmarks(std::vector<Result>& results) {
+    results.push_back(Measure("unique construct+destroy", "MakeUnique", kIterations, [] {
+        auto p = MakeUnique<Payload>(1);
+        DoNotOptimize(p);
+    }));
+    results.push_back(Measure("unique construct+destroy", "std::make_unique", kIterations, [] {
+        auto p = std::make_unique<Payload>(1);
+        DoNotOptimize(p);
+    }));
+
+    // One op is a round trip a -> b -> a
+    auto a = MakeUnique<Payload>(1);
+    UniquePtr<Payload> b;
+    results.push_back(Measure("unique move", "UniquePtr", kIterations, [&] {
+        b = std::move(a);
+        DoNotOptimize(b);
+        a = std::move(b);
+        DoNotOptimize(a);
+    }));
+    auto std_a = std::make_unique<Payload>(1);
+    std::unique_ptr<Payload> std_b;
+    results.push_back(Measure("unique move", "std::unique_ptr", kIterations, [&] {
+        std_b = std::move(std_a);
+        DoNotOptimize(std_b);
+        std_a = std::move(std_b);
+        DoNotOptimize(std_a);
+    }));
+}
+
+void SharedBenchmarks(std::vector<Result>& results) {
+    results.push_back(Measure("shared construct+destroy", "SharedPtr(new T)", kIterations, [] {
+        SharedPtr<Payload> p(new Payload(1));
+        DoNotOptimize(p);
+    }));
+    results.push_back(Measure("shared construct+destroy", "std::shared_ptr(new T)", kIterations,
+                              [] {
+                                  std::shared_ptr<Payload> p(new Payload(1));
+                                  DoNotOptimize(p);
+                              }));
+    results.push_back(Measure("shared construct+destroy", "MakeShared", kIterations, [] {
+        auto p = MakeShared<Payload>(1);
+        DoNotOptimize(p);
+    }));
+    results.push_back(Measure("shared construct+destroy", "std::make_shared", kIterations, [] {
+        auto p = std::make_shared<Payload>(1);
+        DoNotOptimize(p);
+    }));
+
+    auto shared = MakeShared<Payload>(1);
+    results.push_back(Measure("shared copy+destroy", "SharedPtr", kIterations, [&] {
+        SharedPtr<Payload> copy(shared);
+        DoNotOptimize(copy);
+    }));
+    auto std_shared = std::make_shared<Payload>(1);
+    results.push_back(Measure("shared copy+destroy", "std::shared_ptr", kIterations, [&] {
+        std::shared_ptr<Payload> copy(std_shared);
+        DoNotOptimize(copy);
+    }));
+
+    auto a = MakeShared<Payload>(1);
+    SharedPtr<Payload> b;
+    results.push_back(Measure("shared move", "SharedPtr", kIterations, [&] {
+        b = std::move(a);
+        DoNotOptimize(b);
+        a = std::move(b);
+        DoNotOptimize(a);
+    }));
+    auto std_a = std::make_shared<Payload>(1);
+    std::shared_ptr<Payload> std_b;
+    results.push_back(Measure("shared move", "std::shared_ptr", kIterations, [&] {
+        std_b = std::move(std_a);
+        DoNotOptimize(std_b);
+        std_a = std::move(std_b);
+        DoNotOptimize(std_a);
+    }));
+
+    WeakPtr<Payload> weak(shared);
+    results.push_back(Measure("weak lock", "WeakPtr::Lock", kIterations, [&] {
+        auto locked = weak.Lock();
+        DoNotOptimize(locked);
+    }));
+    std::weak_ptr<Payload> std_weak(std_shared);
+    results.push_back(Measure("weak lock", "std::weak_ptr::lock", kIterations, [&] {
+        auto locked = std_weak.lock();
+        DoNotOptimize(locked);
+    }));
+}
+
+void IntrusiveBenchmarks(std::vector<Result>& results) {
+    results.push_back(Measure("intrusive construct+destroy", "MakeIntrusive", kIterations, [] {
+        auto p = MakeIntrusive<IntrusivePayload>(1);
+        DoNotOptimize(p);
+    }));
+    results.push_back(Measure("intrusive construct+destroy", "boost-style", kIterations, [] {
+        BoostStylePtr<BoostStylePayload> p(new BoostStylePayload(1));
+        DoNotOptimize(p);
+    }));
+
+    auto intrusive = MakeIntrusive<IntrusivePayload>(1);
+    results.push_back(Measure("intrusive copy+destroy", "IntrusivePtr", kIterations, [&] {
+        IntrusivePtr<IntrusivePayload> copy(intrusive);
+        DoNotOptimize(copy);
+    }));
+    BoostStylePtr<BoostStylePayload> boost_style(new BoostStylePayload(1));
+    results.push_back(Measure("intrusive copy+destroy", "boost-style", kIterations, [&] {
+        BoostStylePtr<BoostStylePayload> copy(boost_style);
+        DoNotOptimize(copy);
+    }));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<Result> results;
+    UniqueBenchmarks(results);
+    SharedBenchmarks(results);
+    IntrusiveBenchmarks(results);
+    return bench::Report(results, argc, argv) ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include <shared-from-this/shared.h>
+#include <unique/unique.h>
+
+#include <cstddef>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Not part of any target: `bench_compile_time` compiles this file with
+// COMPILE_TIME_TYPES set to the number of distinct payload types and any of
+// COMPILE_TIME_COMPRESSED_PAIR, COMPILE_TIME_UNIQUE, COMPILE_TIME_SHARED and
+// COMPILE_TIME_MAKE_SHARED to choose which templates get instantiated for
+// each of them.
+
+#ifndef COMPILE_TIME_TYPES
+#define COMPILE_TIME_TYPES 1000
+#endif
+
+// Defined nowhere, the file is only compiled. Objects passed to it cannot be
+// optimized away together with the code that manages them.
+void Escape(const void* object);
+
+namespace {
+
+template <size_t I>
+struct Payload {
+    size_t value = I;
+};
+
+// Empty, takes no space in `UniquePtr`
+template <size_t I>
+struct StatelessDeleter {
+    void operator()(Payload<I>* pointer) const {
+        delete pointer;
+    }
+};
+
+// Stored next to the pointer
+template <size_t I>
+struct CountingDeleter {
+    size_t* count = nullptr;
+
+    void operator()(Payload<I>* pointer) const {
+        ++*count;
+        delete pointer;
+    }
+};
+
+// Empty and final, never a base
+template <size_t I>
+struct FinalTag final {};
+
+template <size_t I>
+size_t Use() {
+    [[maybe_unused]] size_t sum = 0;
+#ifdef COMPILE_TIME_COMPRESSED_PAIR
+    {
+        // One of each storage layout
+        CompressedPair<Payload<I>*, StatelessDeleter<I>> pointer_first(nullptr, {});
+        CompressedPair<StatelessDeleter<I>, Payload<I>> payload_second({}, {});
+        CompressedPair<StatelessDeleter<I>, FinalTag<I>> empty_and_final({}, {});
+        CompressedPair<Payload<I>, CountingDeleter<I>> both_stored({}, {});
+        Escape(&pointer_first);
+        Escape(&payload_second);
+        Escape(&empty_and_final);
+        Escape(&both_stored);
+        sum += payload_second.GetSecond().value + both_stored.GetFirst().value;
+    }
+#endif
+#ifdef COMPILE_TIME_UNIQUE
+    {
+        size_t deleted = 0;
+        UniquePtr<Payload<I>> plain(new Payload<I>);
+        UniquePtr<Payload<I>, StatelessDeleter<I>> stateless(new Payload<I>);
+        UniquePtr<Payload<I>, CountingDeleter<I>> counting(new Payload<I>,
+                                                           CountingDeleter<I>{&deleted});
+        auto moved = std::move(stateless);
+        Escape(plain.Get());
+        Escape(moved.Get());
+        Escape(counting.Get());
+        sum += plain->value + moved->value + counting->value;
+        counting.Reset();
+        sum += deleted;
+    }
+#endif
+#ifdef COMPILE_TIME_SHARED
+    {
+        SharedPtr<Payload<I>> shared(new Payload<I>);
+        auto copy = shared;
+        Escape(copy.Get());
+        sum += copy->value + shared.UseCount();
+    }
+#endif
+#ifdef COMPILE_TIME_MAKE_SHARED
+    {
+        auto shared = MakeShared<Payload<I>>();
+        auto copy = shared;
+        Escape(copy.Get());
+        sum += copy->value + shared.UseCount();
+    }
+#endif
+    return sum;
+}
+
+template <size_t... Is>
+size_t UseAll(std::index_sequence<Is...>) {
+    // A table rather than a fold expression, which would nest thousands deep
+    static constexpr size_t (*kUses[])() = {&Use<Is>...};
+    size_t sum = 0;
+    for (auto use : kUses) {
+        sum += use();
+    }
+    return sum;
+}
+
+}  // namespace
+
+size_t CompileTimeUnit() {
+    return UseAll(std::make_index_sequence<COMPILE_TIME_TYPES>{});
+}
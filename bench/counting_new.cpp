@@ -0,0 +1,61 @@
+#include "bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions to count calls. Every other form of
+// `operator new` (nothrow, array) ends up in the plain one in libstdc++, but
+// the aligned ones are replaced as well to keep the count exact.
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+
+void* Allocate(size_t size, size_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* memory;
+    if (alignment > alignof(std::max_align_t)) {
+        // `aligned_alloc` wants the size to be a multiple of the alignment
+        memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    } else {
+        memory = std::malloc(size);
+    }
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+}  // namespace
+
+size_t bench::AllocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size) {
+    return Allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return Allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstddef>
+
+// Opt-in build mode (-DSMART_POINTERS_ACCOUNTING, CMake option of the same
+// name): control blocks and `RefCounted` objects report to a per-type registry
+// how many objects are alive, how many bytes they take and how much the
+// reference counting machinery adds on top. Without the option every hook is
+// an empty inline function and the trackers are empty members, so the
+// pointers are exactly as they were; the registry, the snapshots and their
+// headers are not even compiled.
+
+#ifdef SMART_POINTERS_ACCOUNTING
+#define HAS_ACCOUNTING 1
+#else
+#define HAS_ACCOUNTING 0
+#endif
+
+#if HAS_ACCOUNTING
+#include "json.h"
+#include "type_name.h"
+
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#endif
+
+namespace accounting {
+
+inline constexpr bool kEnabled = HAS_ACCOUNTING;
+
+#if HAS_ACCOUNTING
+
+// Counters of one type at the time of the snapshot. "Overhead" is what
+// reference counting costs beyond the object: a separate control block, the
+// counters sharing an allocation with the object, an embedded counter.
+struct TypeStats {
+    std::string type;
+    size_t live_objects = 0;
+    size_t peak_objects = 0;
+    size_t total_objects = 0;
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+    size_t live_overhead_bytes = 0;
+    size_t peak_overhead_bytes = 0;
+};
+
+namespace detail {
+
+class Gauge {
+public:
+    void Add(size_t value) {
+        size_t now = current_.fetch_add(value, std::memory_order_relaxed) + value;
+        size_t peak = peak_.load(std::memory_order_relaxed);
+        while (now > peak && !peak_.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+        }
+    }
+
+    void Sub(size_t value) {
+        current_.fetch_sub(value, std::memory_order_relaxed);
+    }
+
+    size_t Current() const {
+        return current_.load(std::memory_order_relaxed);
+    }
+
+    size_t Peak() const {
+        return peak_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> current_{0};
+    std::atomic<size_t> peak_{0};
+};
+
+struct TypeEntry {
+    explicit TypeEntry(std::string_view name) : type(name) {
+    }
+
+    std::string type;
+    Gauge objects;
+    Gauge bytes;
+    Gauge overhead;
+    std::atomic<size_t> total{0};
+};
+
+class Registry {
+public:
+    static Registry& Instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    // Entries are never removed and a deque does not move them, so the
+    // reference stays valid for the lifetime of the program
+    TypeEntry& Register(std::string_view type) {
+        std::lock_guard lock(mutex_);
+        for (auto& entry : entries_) {
+            if (entry.type == type) {
+                return entry;
+            }
+        }
+        return entries_.emplace_back(type);
+    }
+
+    std::vector<TypeStats> Snapshot() {
+        std::lock_guard lock(mutex_);
+        std::vector<TypeStats> result;
+        result.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            result.push_back({entry.type, entry.objects.Current(), entry.objects.Peak(),
+                              entry.total.load(std::memory_order_relaxed), entry.bytes.Current(),
+                              entry.bytes.Peak(), entry.overhead.Current(),
+                              entry.overhead.Peak()});
+        }
+        return result;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<TypeEntry> entries_;
+};
+
+template <typename T>
+TypeEntry& EntryFor() {
+    static TypeEntry& entry = Registry::Instance().Register(TypeName<T>());
+    return entry;
+}
+
+}  // namespace detail
+
+#endif  // HAS_ACCOUNTING
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hooks
+
+template <typename T>
+inline void ObjectCreated([[maybe_unused]] size_t bytes = sizeof(T)) {
+#if HAS_ACCOUNTING
+    auto& entry = detail::EntryFor<T>();
+    entry.objects.Add(1);
+    entry.bytes.Add(bytes);
+    entry.total.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+template <typename T>
+inline void ObjectDestroyed([[maybe_unused]] size_t bytes = sizeof(T)) {
+#if HAS_ACCOUNTING
+    auto& entry = detail::EntryFor<T>();
+    entry.objects.Sub(1);
+    entry.bytes.Sub(bytes);
+#endif
+}
+
+template <typename T>
+inline void OverheadAdded([[maybe_unused]] size_t bytes) {
+#if HAS_ACCOUNTING
+    detail::EntryFor<T>().overhead.Add(bytes);
+#endif
+}
+
+template <typename T>
+inline void OverheadRemoved([[maybe_unused]] size_t bytes) {
+#if HAS_ACCOUNTING
+    detail::EntryFor<T>().overhead.Sub(bytes);
+#endif
+}
+
+// Member of an intrusively counted base: reports `Derived` objects together
+// with `Overhead` bytes of embedded counter. Empty when accounting is off, so
+// `[[no_unique_address]]` makes it free and the base stays trivial.
+template <typename Derived, size_t Overhead, bool = kEnabled>
+struct ObjectTracker {};
+
+template <typename Derived, size_t Overhead>
+struct ObjectTracker<Derived, Overhead, true> {
+    ObjectTracker() {
+        ObjectCreated<Derived>();
+        OverheadAdded<Derived>(Overhead);
+    }
+
+    ObjectTracker(const ObjectTracker&) : ObjectTracker() {
+    }
+
+    ObjectTracker& operator=(const ObjectTracker&) {
+        return *this;
+    }
+
+    ~ObjectTracker() {
+        ObjectDestroyed<Derived>();
+        OverheadRemoved<Derived>(Overhead);
+    }
+};
+
+#if HAS_ACCOUNTING
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Snapshots, only in this mode
+
+// Every type seen so far, in order of first appearance
+inline std::vector<TypeStats> Snapshot() {
+    return detail::Registry::Instance().Snapshot();
+}
+
+template <typename T>
+TypeStats SnapshotOf() {
+    for (auto& stats : Snapshot()) {
+        if (stats.type == TypeName<T>()) {
+            return stats;
+        }
+    }
+    return {std::string(TypeName<T>())};
+}
+
+inline std::string ToJson(const std::vector<TypeStats>& snapshot) {
+    std::string json = "[";
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        const auto& stats = snapshot[i];
+        char numbers[320];
+        std::snprintf(numbers, sizeof(numbers),
+                      "\"live_objects\": %zu, \"peak_objects\": %zu, \"total_objects\": %zu, "
+                      "\"live_bytes\": %zu, \"peak_bytes\": %zu, \"live_overhead_bytes\": %zu, "
+                      "\"peak_overhead_bytes\": %zu",
+                      stats.live_objects, stats.peak_objects, stats.total_objects,
+                      stats.live_bytes, stats.peak_bytes, stats.live_overhead_bytes,
+                      stats.peak_overhead_bytes);
+        json += i ? ",\n  " : "\n  ";
+        json += "{\"type\": \"" + EscapeJson(stats.type) + "\", " + numbers + "}";
+    }
+    json += snapshot.empty() ? "]" : "\n]";
+    return json;
+}
+
+#endif  // HAS_ACCOUNTING
+
+}  // namespace accounting
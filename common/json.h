@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Escapes quotes and backslashes, for string values in JSON and in Graphviz
+// DOT labels, which quote the same way
+inline std::string EscapeJson(std::string_view text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result;
+}
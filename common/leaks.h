@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Opt-in debug mode (-DSMART_POINTERS_LEAKS, CMake option of the same name):
+// every live control block and every referenced `RefCounted` object is kept in
+// a registry together with its type and the stack that created it. At
+// shutdown, on a signal or on demand the registry is dumped with current
+// strong/weak counts, which tells which `SharedPtr` graph a leak comes from.
+//
+// The registry is split into shards by address, each under its own mutex, so
+// threads creating objects rarely wait for each other. The creation stack is
+// `kMaxFrames` raw return addresses from `backtrace()`; symbols are only
+// looked up when dumping.
+//
+// Counts are read while their owners may still be using them, so a dump taken
+// from another thread is a best-effort picture of a running program. Each
+// registration allocates, so tests counting allocations do not hold in this
+// mode.
+//
+// Without the option the hooks are empty and there is nothing to dump; the
+// registry, the dumps and their headers are not compiled.
+
+#ifdef SMART_POINTERS_LEAKS
+#define HAS_LEAKS 1
+#else
+#define HAS_LEAKS 0
+#endif
+
+#if HAS_LEAKS
+#include "type_name.h"
+
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#endif
+
+namespace leaks {
+
+inline constexpr bool kEnabled = HAS_LEAKS;
+
+inline constexpr size_t kMaxFrames = 12;
+
+struct Counts {
+    size_t strong = 0;
+    size_t weak = 0;
+};
+
+// Reads the counts of a registered object given its registered address
+using CountsFunction = Counts (*)(const void* address);
+
+struct LiveObject {
+    const void* address = nullptr;
+    std::string_view type;
+    size_t size = 0;
+    Counts counts;
+    // Innermost frame first
+    std::vector<void*> stack;
+};
+
+#if HAS_LEAKS
+
+namespace detail {
+
+struct Record {
+    std::string_view type;
+    size_t size;
+    CountsFunction counts;
+    uint64_t serial;
+    int depth;
+    void* frames[kMaxFrames];
+};
+
+class Registry {
+public:
+    static constexpr size_t kShards = 16;
+
+    static Registry& Instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    void Add(const void* address, const Record& record) {
+        auto& shard = ShardOf(address);
+        std::lock_guard lock(shard.mutex);
+        shard.records.insert_or_assign(address, record);
+    }
+
+    void Remove(const void* address) {
+        auto& shard = ShardOf(address);
+        std::lock_guard lock(shard.mutex);
+        shard.records.erase(address);
+    }
+
+    // In order of creation
+    std::vector<LiveObject> Collect() {
+        std::vector<std::pair<uint64_t, LiveObject>> found;
+        for (auto& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            for (const auto& [address, record] : shard.records) {
+                found.emplace_back(record.serial,
+                                   LiveObject{address, record.type, record.size,
+                                              record.counts(address),
+                                              {record.frames, record.frames + record.depth}});
+            }
+        }
+        std::sort(found.begin(), found.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        std::vector<LiveObject> result;
+        result.reserve(found.size());
+        for (auto& [serial, object] : found) {
+            result.push_back(std::move(object));
+        }
+        return result;
+    }
+
+    uint64_t NextSerial() {
+        return serial_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<const void*, Record> records;
+    };
+
+    Shard& ShardOf(const void* address) {
+        // Low bits are alignment, the ones above are close to random
+        return shards_[(reinterpret_cast<uintptr_t>(address) >> 6) % kShards];
+    }
+
+    Shard shards_[kShards];
+    std::atomic<uint64_t> serial_{0};
+};
+
+}  // namespace detail
+
+#endif  // HAS_LEAKS
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hooks
+
+// Registers a live object of type `T` under `address`. `counts` gets the same
+// address back when the registry is dumped, until `Untrack(address)`.
+template <typename T>
+inline void Track([[maybe_unused]] const void* address, [[maybe_unused]] CountsFunction counts,
+                  [[maybe_unused]] size_t size = sizeof(T)) {
+#if HAS_LEAKS
+    auto& registry = detail::Registry::Instance();
+    detail::Record record{TypeName<T>(), size, counts, registry.NextSerial(), 0, {}};
+    // Skip this frame, the caller's is the interesting one
+    void* frames[kMaxFrames + 1];
+    int depth = backtrace(frames, kMaxFrames + 1);
+    for (int i = 1; i < depth; ++i) {
+        record.frames[i - 1] = frames[i];
+    }
+    record.depth = depth > 0 ? depth - 1 : 0;
+    registry.Add(address, record);
+#endif
+}
+
+inline void Untrack([[maybe_unused]] const void* address) {
+#if HAS_LEAKS
+    detail::Registry::Instance().Remove(address);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reports
+
+// Everything registered and not yet released, oldest first. Empty when the
+// mode is off.
+inline std::vector<LiveObject> LiveObjects() {
+#if HAS_LEAKS
+    return detail::Registry::Instance().Collect();
+#else
+    return {};
+#endif
+}
+
+#if HAS_LEAKS
+
+// Prints every live object with its counts and creation stack, returns how
+// many there were
+inline size_t Dump(std::FILE* out) {
+    auto objects = LiveObjects();
+    std::fprintf(out, "%zu live objects\n", objects.size());
+    for (const auto& object : objects) {
+        std::fprintf(out, "%p %.*s, %zu bytes, strong %zu, weak %zu\n", object.address,
+                     static_cast<int>(object.type.size()), object.type.data(), object.size,
+                     object.counts.strong, object.counts.weak);
+        if (object.stack.empty()) {
+            continue;
+        }
+        auto depth = static_cast<int>(object.stack.size());
+        char** symbols = backtrace_symbols(object.stack.data(), depth);
+        for (size_t i = 0; i < object.stack.size(); ++i) {
+            std::fprintf(out, "    #%zu %s\n", i, symbols ? symbols[i] : "?");
+        }
+        std::free(symbols);
+    }
+    std::fflush(out);
+    return objects.size();
+}
+
+// Dumps whatever is still alive when the program exits normally. Objects
+// owned by globals destroyed after the dump show up too.
+inline void DumpAtExit(std::FILE* out = stderr) {
+    static std::FILE* target;
+    target = out;
+    // Constructed before the handler is registered, so it outlives it
+    detail::Registry::Instance();
+    [[maybe_unused]] static const bool registered = [] {
+        std::atexit([] { Dump(target); });
+        return true;
+    }();
+}
+
+// Dumps on every delivery of `signal` (e.g. SIGUSR1) from a dedicated thread,
+// since a signal handler itself must not lock or allocate. Call it before
+// starting other threads: they inherit the blocked signal mask, so the signal
+// always reaches the waiting thread.
+inline void DumpOnSignal(int signal, std::FILE* out = stderr) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, signal);
+    pthread_sigmask(SIG_BLOCK, &set, nullptr);
+    detail::Registry::Instance();
+    std::thread([set, out] {
+        int received;
+        while (sigwait(&set, &received) == 0) {
+            Dump(out);
+        }
+    }).detach();
+}
+
+#endif  // HAS_LEAKS
+
+}  // namespace leaks
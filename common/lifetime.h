@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+
+// Opt-in build mode (-DSMART_POINTERS_LIFETIME, CMake option of the same
+// name): every object owned through a control block or `RefCounted` is
+// timestamped when it is created, and its lifetime goes into a per-type
+// histogram when it is destroyed. Useful to tell short-lived objects (pool
+// them) from long-lived ones (defer their destruction) before tuning either.
+//
+// Buckets are log-scale with `kSubBuckets` linear steps per power of two, so
+// a recorded lifetime is known to within 25% at any scale. Each type has a
+// few cache-line-aligned shards picked by thread; recording is a relaxed
+// increment with no locks, and reads merge the shards.
+//
+// Without the option the stopwatches are empty members and the report prints
+// a bare header; the histograms, the registry and their headers are not
+// compiled.
+
+#ifdef SMART_POINTERS_LIFETIME
+#define HAS_LIFETIME 1
+#else
+#define HAS_LIFETIME 0
+#endif
+
+#if HAS_LIFETIME
+#include "type_name.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#endif
+
+namespace lifetime {
+
+inline constexpr bool kEnabled = HAS_LIFETIME;
+
+#if HAS_LIFETIME
+
+using Clock = std::chrono::steady_clock;
+using Nanoseconds = std::chrono::nanoseconds;
+
+inline constexpr size_t kSubBucketBits = 2;
+inline constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+// Lifetimes from 2^41 ns (about 36 minutes) on share the last bucket
+inline constexpr size_t kMaxExponent = 40;
+inline constexpr size_t kBuckets = kSubBuckets + (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+// Values below `kSubBuckets` get a bucket each; from there on every power of
+// two is split into `kSubBuckets` equal steps
+constexpr size_t BucketIndex(uint64_t ns) {
+    if (ns < kSubBuckets) {
+        return ns;
+    }
+    size_t exponent = std::bit_width(ns) - 1;
+    if (exponent > kMaxExponent) {
+        return kBuckets - 1;
+    }
+    size_t step = (ns >> (exponent - kSubBucketBits)) - kSubBuckets;
+    return kSubBuckets + (exponent - kSubBucketBits) * kSubBuckets + step;
+}
+
+// Smallest lifetime that lands in bucket `index`
+constexpr uint64_t BucketLowerBound(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    size_t exponent = (index - kSubBuckets) / kSubBuckets + kSubBucketBits;
+    size_t step = (index - kSubBuckets) % kSubBuckets;
+    return uint64_t{kSubBuckets + step} << (exponent - kSubBucketBits);
+}
+
+// Merged histogram of one type at the time of the snapshot
+struct Histogram {
+    std::string type;
+    size_t count = 0;
+    Nanoseconds total{0};
+    Nanoseconds max{0};
+    std::array<size_t, kBuckets> buckets{};
+
+    Nanoseconds Mean() const {
+        return count ? total / static_cast<Nanoseconds::rep>(count) : Nanoseconds{0};
+    }
+
+    // Estimate of the `q`-th quantile (0 < q <= 1): the middle of the bucket
+    // holding it, capped by the largest lifetime seen
+    Nanoseconds Quantile(double q) const {
+        if (count == 0) {
+            return Nanoseconds{0};
+        }
+        auto rank = static_cast<size_t>(q * static_cast<double>(count - 1)) + 1;
+        size_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                if (i + 1 == kBuckets) {
+                    return max;
+                }
+                uint64_t middle = (BucketLowerBound(i) + BucketLowerBound(i + 1) - 1) / 2;
+                return std::min(Nanoseconds(middle), max);
+            }
+        }
+        return max;
+    }
+};
+
+namespace detail {
+
+inline constexpr size_t kShards = 8;
+
+inline size_t ThreadShard() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t shard = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return shard;
+}
+
+// Written by the threads mapped to it, read by snapshots. Aligned so that
+// threads recording the same type do not share cache lines.
+struct alignas(64) Shard {
+    std::atomic<uint64_t> buckets[kBuckets] = {};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+
+    void Record(uint64_t ns) {
+        buckets[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        total_ns.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = max_ns.load(std::memory_order_relaxed);
+        while (ns > max && !max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void Clear() {
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct TypeEntry {
+    explicit TypeEntry(std::string_view name) : type(name) {
+    }
+
+    std::string type;
+    Shard shards[kShards];
+
+    Histogram Merge() const {
+        Histogram result{type};
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        for (const auto& shard : shards) {
+            for (size_t i = 0; i < kBuckets; ++i) {
+                result.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+            }
+            total_ns += shard.total_ns.load(std::memory_order_relaxed);
+            max_ns = std::max(max_ns, shard.max_ns.load(std::memory_order_relaxed));
+        }
+        for (size_t bucket : result.buckets) {
+            result.count += bucket;
+        }
+        result.total = Nanoseconds(total_ns);
+        result.max = Nanoseconds(max_ns);
+        return result;
+    }
+};
+
+class Registry {
+public:
+    static Registry& Instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    // Entries are never removed and a deque does not move them, so the
+    // reference stays valid for the lifetime of the program
+    TypeEntry& Register(std::string_view type) {
+        std::lock_guard lock(mutex_);
+        for (auto& entry : entries_) {
+            if (entry.type == type) {
+                return entry;
+            }
+        }
+        return entries_.emplace_back(type);
+    }
+
+    std::vector<Histogram> Snapshot() {
+        std::lock_guard lock(mutex_);
+        std::vector<Histogram> result;
+        result.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            result.push_back(entry.Merge());
+        }
+        return result;
+    }
+
+    void Clear() {
+        std::lock_guard lock(mutex_);
+        for (auto& entry : entries_) {
+            for (auto& shard : entry.shards) {
+                shard.Clear();
+            }
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<TypeEntry> entries_;
+};
+
+template <typename T>
+TypeEntry& EntryFor() {
+    static TypeEntry& entry = Registry::Instance().Register(TypeName<T>());
+    return entry;
+}
+
+}  // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hooks
+
+// Adds one lifetime of a `T` to its histogram
+template <typename T>
+inline void Record(Nanoseconds lifetime) {
+    auto ns = static_cast<uint64_t>(std::max(lifetime.count(), Nanoseconds::rep{0}));
+    detail::EntryFor<T>().shards[detail::ThreadShard()].Record(ns);
+}
+
+#endif  // HAS_LIFETIME
+
+// Member of a control block: started when the block (and with it the object)
+// is created, stopped when the object is destroyed. Empty when the mode is
+// off, so `[[no_unique_address]]` makes it free.
+template <typename T, bool = kEnabled>
+struct Stopwatch {
+    void Stop() {
+    }
+};
+
+#if HAS_LIFETIME
+template <typename T>
+struct Stopwatch<T, true> {
+    void Stop() {
+        Record<T>(Clock::now() - born);
+    }
+
+    Clock::time_point born = Clock::now();
+};
+#endif
+
+// Member of an intrusively counted base: the object's lifetime is the
+// member's, a copy is a new object
+template <typename Derived, bool = kEnabled>
+struct LifetimeTracker {};
+
+#if HAS_LIFETIME
+template <typename Derived>
+struct LifetimeTracker<Derived, true> {
+    LifetimeTracker() = default;
+
+    LifetimeTracker(const LifetimeTracker&) {
+    }
+
+    LifetimeTracker& operator=(const LifetimeTracker&) {
+        return *this;
+    }
+
+    ~LifetimeTracker() {
+        stopwatch.Stop();
+    }
+
+    Stopwatch<Derived, true> stopwatch;
+};
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reports
+
+#if HAS_LIFETIME
+
+// Every type seen so far, in order of first appearance
+inline std::vector<Histogram> Snapshot() {
+    return detail::Registry::Instance().Snapshot();
+}
+
+template <typename T>
+Histogram HistogramOf() {
+    return detail::EntryFor<T>().Merge();
+}
+
+#endif  // HAS_LIFETIME
+
+// Zeroes every histogram; types stay registered
+inline void Reset() {
+#if HAS_LIFETIME
+    detail::Registry::Instance().Clear();
+#endif
+}
+
+inline void PrintReport(std::FILE* out) {
+    std::fprintf(out, "%10s %12s %12s %12s %12s %12s  %s\n", "objects", "mean us", "p50 us",
+                 "p90 us", "p99 us", "max us", "type");
+#if HAS_LIFETIME
+    auto micros = [](Nanoseconds value) { return static_cast<double>(value.count()) / 1000; };
+    for (const auto& histogram : Snapshot()) {
+        if (histogram.count == 0) {
+            continue;
+        }
+        std::fprintf(out, "%10zu %12.2f %12.2f %12.2f %12.2f %12.2f  %s\n", histogram.count,
+                     micros(histogram.Mean()), micros(histogram.Quantile(0.5)),
+                     micros(histogram.Quantile(0.9)), micros(histogram.Quantile(0.99)),
+                     micros(histogram.max), histogram.type.c_str());
+    }
+#endif
+}
+
+}  // namespace lifetime
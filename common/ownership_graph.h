@@ -0,0 +1,278 @@
+#pragma once
+
+#include "json.h"
+#include "type_name.h"
+
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+#include <shared-from-this/weak.h>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Debug facility: who holds what. Starting from named roots, `Tracer` follows
+// `SharedPtr`, `WeakPtr` and `IntrusivePtr` edges through objects whose types
+// have a registered trace function, and records every control block (or
+// intrusively counted object) it reaches. The result exports to Graphviz DOT
+// or JSON; a chain of strong edges ending in a big `MakeShared` block is what
+// keeps its memory alive.
+//
+//   ownership::RegisterTrace<Node>([](const Node& node, ownership::Tracer& tracer) {
+//       tracer.Edge(node.next, "next");
+//       tracer.Edge(node.parent, "parent");
+//   });
+//   ownership::Tracer tracer;
+//   tracer.Root("head", head);
+//   std::puts(tracer.GetGraph().ToDot().c_str());
+//
+// Trace functions are looked up by the static type of the pointer, so an
+// object held through `SharedPtr<Base>` is traced as a `Base`. The walk reads
+// the pointers as they are: nothing may modify the graph while it runs.
+
+namespace ownership {
+
+enum class EdgeKind { kStrong, kWeak };
+
+struct Node {
+    // The control block, or the object itself for intrusive pointers
+    const void* address = nullptr;
+    std::string type;
+    // Bytes this node keeps allocated: the block plus the object while it
+    // lives, or the whole block for `MakeShared`, whose storage outlives the
+    // object until the last weak reference is gone
+    size_t size = 0;
+    size_t strong = 0;
+    size_t weak = 0;
+};
+
+struct Edge {
+    size_t from = 0;
+    size_t to = 0;
+    EdgeKind kind = EdgeKind::kStrong;
+    std::string label;
+};
+
+struct Root {
+    std::string name;
+    size_t to = 0;
+    EdgeKind kind = EdgeKind::kStrong;
+};
+
+inline std::string_view KindName(EdgeKind kind) {
+    return kind == EdgeKind::kStrong ? "strong" : "weak";
+}
+
+// Nodes are numbered in order of discovery, breadth first from the roots
+struct Graph {
+    std::vector<Node> nodes;
+    std::vector<Root> roots;
+    std::vector<Edge> edges;
+
+    std::string ToDot() const {
+        std::string dot = "digraph ownership {\n";
+        for (size_t i = 0; i < roots.size(); ++i) {
+            dot += "    root" + std::to_string(i) + " [shape=plaintext, label=\"" +
+                   EscapeJson(roots[i].name) + "\"];\n";
+        }
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const auto& node = nodes[i];
+            dot += "    n" + std::to_string(i) + " [shape=box, ";
+            if (node.strong == 0) {
+                dot += "style=dashed, ";
+            }
+            dot += "label=\"" + EscapeJson(node.type) + "\\n" +
+                   std::to_string(node.size) + " bytes, strong " + std::to_string(node.strong) +
+                   ", weak " + std::to_string(node.weak) + "\"];\n";
+        }
+        for (size_t i = 0; i < roots.size(); ++i) {
+            dot += "    root" + std::to_string(i) + " -> n" + std::to_string(roots[i].to) +
+                   Attributes(roots[i].kind, {}) + ";\n";
+        }
+        for (const auto& edge : edges) {
+            dot += "    n" + std::to_string(edge.from) + " -> n" + std::to_string(edge.to) +
+                   Attributes(edge.kind, edge.label) + ";\n";
+        }
+        dot += "}\n";
+        return dot;
+    }
+
+    std::string ToJson() const {
+        std::string json = "{\n  \"nodes\": [";
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const auto& node = nodes[i];
+            json += i ? ",\n    " : "\n    ";
+            json += "{\"id\": " + std::to_string(i) + ", \"type\": \"" +
+                    EscapeJson(node.type) + "\", \"size\": " +
+                    std::to_string(node.size) + ", \"strong\": " + std::to_string(node.strong) +
+                    ", \"weak\": " + std::to_string(node.weak) + "}";
+        }
+        json += nodes.empty() ? "],\n" : "\n  ],\n";
+        json += "  \"roots\": [";
+        for (size_t i = 0; i < roots.size(); ++i) {
+            json += i ? ",\n    " : "\n    ";
+            json += "{\"name\": \"" + EscapeJson(roots[i].name) +
+                    "\", \"to\": " + std::to_string(roots[i].to) + ", \"kind\": \"" +
+                    std::string(KindName(roots[i].kind)) + "\"}";
+        }
+        json += roots.empty() ? "],\n" : "\n  ],\n";
+        json += "  \"edges\": [";
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const auto& edge = edges[i];
+            json += i ? ",\n    " : "\n    ";
+            json += "{\"from\": " + std::to_string(edge.from) + ", \"to\": " +
+                    std::to_string(edge.to) + ", \"kind\": \"" + std::string(KindName(edge.kind)) +
+                    "\", \"label\": \"" + EscapeJson(edge.label) + "\"}";
+        }
+        json += edges.empty() ? "]\n}\n" : "\n  ]\n}\n";
+        return json;
+    }
+
+private:
+    static std::string Attributes(EdgeKind kind, std::string_view label) {
+        std::string attributes;
+        if (kind == EdgeKind::kWeak) {
+            attributes += "style=dashed";
+        }
+        if (!label.empty()) {
+            attributes += attributes.empty() ? "" : ", ";
+            attributes += "label=\"" + EscapeJson(label) + "\"";
+        }
+        return attributes.empty() ? "" : " [" + attributes + "]";
+    }
+};
+
+class Tracer;
+
+template <typename T>
+using TraceFunction = std::function<void(const T&, Tracer&)>;
+
+namespace detail {
+
+// Types without one are leaves
+template <typename T>
+inline TraceFunction<T> trace;
+
+}  // namespace detail
+
+// Tells the tracer which pointers a `T` holds, by calling `Tracer::Edge` on
+// each of them. Replaces an earlier function for the same type.
+template <typename T>
+void RegisterTrace(TraceFunction<T> function) {
+    detail::trace<std::remove_cv_t<T>> = std::move(function);
+}
+
+class Tracer {
+public:
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Roots
+
+    // Walks everything reachable from `pointer`. Objects already reached from
+    // earlier roots are not walked again.
+    template <typename P>
+    void Root(std::string_view name, const P& pointer) {
+        from_ = kRoot;
+        Edge(pointer, name);
+        while (!pending_.empty()) {
+            auto visit = std::move(pending_.front());
+            pending_.pop_front();
+            visit();
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Edges, for trace functions. Empty pointers are skipped.
+
+    template <typename T>
+    void Edge(const SharedPtr<T>& pointer, std::string_view label = {}) {
+        if (BaseBlock* block = pointer.GetControlBlock()) {
+            AddEdge(VisitBlock<T>(block, pointer.Get()), EdgeKind::kStrong, label);
+        }
+    }
+
+    template <typename T>
+    void Edge(const WeakPtr<T>& pointer, std::string_view label = {}) {
+        if (BaseBlock* block = pointer.GetControlBlock()) {
+            // Locking only to reach the object: the temporary strong reference
+            // is gone by the time `VisitBlock` reads the counts. Expired
+            // pointers are not locked, so exports do not fire `lock_failed`
+            // for them, unless the last owner lets go in between.
+            const T* object = nullptr;
+            if (!ids_.contains(block) && !pointer.Expired()) {
+                object = pointer.Lock().Get();
+            }
+            AddEdge(VisitBlock<T>(block, object), EdgeKind::kWeak, label);
+        }
+    }
+
+    template <typename T>
+    void Edge(const IntrusivePtr<T>& pointer, std::string_view label = {}) {
+        if (const T* object = pointer.Get()) {
+            auto [id, added] = AddNode(object, TypeName<std::remove_cv_t<T>>(), sizeof(T),
+                                       object->RefCount(), 0);
+            if (added) {
+                Schedule(id, object);
+            }
+            AddEdge(id, EdgeKind::kStrong, label);
+        }
+    }
+
+    const Graph& GetGraph() const {
+        return graph_;
+    }
+
+private:
+    static constexpr size_t kRoot = static_cast<size_t>(-1);
+
+    template <typename T>
+    size_t VisitBlock(BaseBlock* block, const T* object) {
+        using U = std::remove_cv_t<T>;
+        size_t strong = block->GetStrongReferenceCount();
+        // The block knows its own type, which `T` (maybe a base) does not tell
+        auto [id, added] = AddNode(block, TypeName<U>(), block->AllocatedSize(), strong,
+                                   block->GetWeakReferenceCount());
+        if (added && strong && object) {
+            Schedule(id, object);
+        }
+        return id;
+    }
+
+    std::pair<size_t, bool> AddNode(const void* address, std::string_view type, size_t size,
+                                    size_t strong, size_t weak) {
+        auto [it, added] = ids_.try_emplace(address, graph_.nodes.size());
+        if (added) {
+            graph_.nodes.push_back({address, std::string(type), size, strong, weak});
+        }
+        return {it->second, added};
+    }
+
+    void AddEdge(size_t to, EdgeKind kind, std::string_view label) {
+        if (from_ == kRoot) {
+            graph_.roots.push_back({std::string(label), to, kind});
+        } else {
+            graph_.edges.push_back({from_, to, kind, std::string(label)});
+        }
+    }
+
+    template <typename T>
+    void Schedule(size_t id, const T* object) {
+        pending_.push_back([this, id, object] {
+            if (auto& trace = detail::trace<std::remove_cv_t<T>>) {
+                from_ = id;
+                trace(*object, *this);
+            }
+        });
+    }
+
+    Graph graph_;
+    std::unordered_map<const void*, size_t> ids_;
+    std::deque<std::function<void()>> pending_;
+    size_t from_ = kRoot;
+};
+
+}  // namespace ownership
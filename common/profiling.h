@@ -0,0 +1,267 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+// Opt-in build mode (-DSMART_POINTERS_PROFILING, CMake option of the same
+// name): a sampling profiler for reference count traffic. Every N-th strong
+// count change on a thread records the control block (or intrusively counted
+// object), its type and the thread. Objects whose counts are changed from many
+// threads are the ones whose cache line bounces between cores.
+//
+// The hot path is a thread-local countdown; samples are buffered per thread
+// and merged under a lock once per `kFlushSize` samples, so at the default
+// 1/1000 rate the profiler stays well under the cost of the atomic it watches.
+//
+// Objects are told apart by address. When an object dies and another of the
+// same type is allocated at its address, both are reported as one object, with
+// the samples and threads of both: short-lived per-thread objects can look
+// shared. Profile long-lived objects, or reset between phases.
+//
+// Without the option the hook is empty and the reports are empty too; the
+// aggregator and its headers are not compiled.
+
+#ifdef SMART_POINTERS_PROFILING
+#define HAS_PROFILING 1
+#else
+#define HAS_PROFILING 0
+#endif
+
+#if HAS_PROFILING
+#include "type_name.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#endif
+
+namespace profiling {
+
+inline constexpr bool kEnabled = HAS_PROFILING;
+
+inline constexpr size_t kDefaultSampleRate = 1000;
+
+struct HotObject {
+    const void* address = nullptr;
+    std::string_view type;
+    size_t samples = 0;
+    size_t threads = 0;  // distinct threads seen touching the count
+};
+
+#if HAS_PROFILING
+
+namespace detail {
+
+struct Sample {
+    const void* address;
+    std::string_view type;
+    size_t thread;
+};
+
+inline constexpr size_t kFlushSize = 256;
+
+// 0 turns sampling off
+inline std::atomic<size_t> sample_rate{kDefaultSampleRate};
+
+inline size_t ThreadIndex() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+// Bounded table of sampled objects. Short-lived objects keep arriving at new
+// addresses, so when the table is full the ones sampled only once are
+// forgotten; if every entry is hotter than that, new objects are dropped.
+class Aggregator {
+public:
+    static constexpr size_t kMaxObjects = 4096;
+
+    static Aggregator& Instance() {
+        static Aggregator aggregator;
+        return aggregator;
+    }
+
+    void Merge(const std::vector<Sample>& samples) {
+        std::lock_guard lock(mutex_);
+        for (const auto& sample : samples) {
+            auto it = objects_.find(sample.address);
+            if (it == objects_.end()) {
+                if (objects_.size() == kMaxObjects && !Evict()) {
+                    continue;
+                }
+                it = objects_.emplace(sample.address, Entry{sample.type}).first;
+            } else if (it->second.type != sample.type) {
+                // The address was reused by an object of another type
+                it->second = Entry{sample.type};
+            }
+            ++it->second.samples;
+            // Thread indices past 64 share bits, so counts above 64 are a lower bound
+            it->second.threads |= uint64_t{1} << (sample.thread % 64);
+        }
+    }
+
+    std::vector<HotObject> Collect() {
+        std::lock_guard lock(mutex_);
+        std::vector<HotObject> result;
+        result.reserve(objects_.size());
+        for (const auto& [address, entry] : objects_) {
+            result.push_back({address, entry.type, entry.samples,
+                              static_cast<size_t>(std::popcount(entry.threads))});
+        }
+        return result;
+    }
+
+    void Clear() {
+        std::lock_guard lock(mutex_);
+        objects_.clear();
+    }
+
+private:
+    struct Entry {
+        std::string_view type;
+        size_t samples = 0;
+        uint64_t threads = 0;
+    };
+
+    bool Evict() {
+        std::erase_if(objects_, [](const auto& item) { return item.second.samples == 1; });
+        return objects_.size() < kMaxObjects;
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<const void*, Entry> objects_;
+};
+
+// Samples of one thread, merged when full and when the thread exits
+class ThreadBuffer {
+public:
+    ThreadBuffer() {
+        samples_.reserve(kFlushSize);
+    }
+
+    ~ThreadBuffer() {
+        Flush();
+    }
+
+    void Add(const void* address, std::string_view type) {
+        samples_.push_back({address, type, ThreadIndex()});
+        if (samples_.size() == kFlushSize) {
+            Flush();
+        }
+    }
+
+    void Flush() {
+        if (!samples_.empty()) {
+            Aggregator::Instance().Merge(samples_);
+            samples_.clear();
+        }
+    }
+
+private:
+    std::vector<Sample> samples_;
+};
+
+inline ThreadBuffer& LocalBuffer() {
+    thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+// Returns the number of count changes until the next sample
+inline size_t Record(const void* address, std::string_view type) {
+    size_t rate = sample_rate.load(std::memory_order_relaxed);
+    if (rate == 0) {
+        // Sampling is off, check again later
+        return kDefaultSampleRate;
+    }
+    LocalBuffer().Add(address, type);
+    return rate;
+}
+
+// Kept apart from `ThreadBuffer` so the fast path touches a trivial
+// thread-local and needs no guard for lazy construction
+inline thread_local size_t countdown = 1;
+
+// Out of line, so the fast path of the hook is a decrement and a branch, with
+// nothing to spill around the call
+template <typename T>
+[[gnu::noinline, gnu::cold]] void RecordSlow(const void* address) {
+    static constexpr std::string_view kType = TypeName<T>();
+    countdown = Record(address, kType);
+}
+
+}  // namespace detail
+
+#endif  // HAS_PROFILING
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Hook
+
+// Called on every strong count change of `address`, an object of type `T`
+template <typename T>
+inline void OnRefCountChange([[maybe_unused]] const void* address) {
+#if HAS_PROFILING
+    if (--detail::countdown == 0) [[unlikely]] {
+        detail::RecordSlow<T>(address);
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Control and reports
+
+// Record one of every `rate` count changes per thread; 0 stops sampling. The
+// calling thread samples its next change, other threads switch to the new
+// rate after their current countdown.
+inline void SetSampleRate([[maybe_unused]] size_t rate) {
+#if HAS_PROFILING
+    detail::sample_rate.store(rate, std::memory_order_relaxed);
+    detail::countdown = 1;
+#endif
+}
+
+// Merges the calling thread's pending samples. Other threads' samples are
+// merged as their buffers fill up or when they exit.
+inline void Flush() {
+#if HAS_PROFILING
+    detail::LocalBuffer().Flush();
+#endif
+}
+
+// Drops everything merged so far. Samples still buffered in other threads
+// show up later.
+inline void Reset() {
+#if HAS_PROFILING
+    detail::LocalBuffer().Flush();
+    detail::Aggregator::Instance().Clear();
+#endif
+}
+
+// Most contended objects first: by number of distinct threads, then samples
+inline std::vector<HotObject> HottestObjects([[maybe_unused]] size_t limit = 20) {
+#if HAS_PROFILING
+    Flush();
+    auto objects = detail::Aggregator::Instance().Collect();
+    std::sort(objects.begin(), objects.end(), [](const HotObject& a, const HotObject& b) {
+        return a.threads != b.threads ? a.threads > b.threads : a.samples > b.samples;
+    });
+    objects.resize(std::min(limit, objects.size()));
+    return objects;
+#else
+    return {};
+#endif
+}
+
+inline void PrintReport(std::FILE* out, size_t limit = 20) {
+    std::fprintf(out, "%-18s %8s %8s  %s\n", "address", "threads", "samples", "type");
+    for (const auto& object : HottestObjects(limit)) {
+        std::fprintf(out, "%-18p %8zu %8zu  %.*s\n", object.address, object.threads,
+                     object.samples, static_cast<int>(object.type.size()), object.type.data());
+    }
+}
+
+}  // namespace profiling
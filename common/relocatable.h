@@ -0,0 +1,15 @@
+#pragma once
+
+#include <type_traits>
+
+// A type is trivially relocatable if moving an object to a new address and
+// ending the lifetime of the old one can be done with `memcpy`: nothing
+// points back at the object itself. Owning pointers qualify even though
+// their move constructors and destructors are not trivial.
+//
+// Specialize for your types next to their definition.
+template <typename T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+inline constexpr bool kIsTriviallyRelocatable = IsTriviallyRelocatable<std::remove_cv_t<T>>::value;
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "relocatable.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+// Minimal growable array that relocates trivially relocatable elements with
+// `realloc` instead of a move constructor + destructor call per element.
+// Other types are moved one by one, like in `std::vector`.
+template <typename T>
+class RelocatingVector {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+public:
+    RelocatingVector() = default;
+
+    RelocatingVector(const RelocatingVector&) = delete;
+    RelocatingVector& operator=(const RelocatingVector&) = delete;
+
+    RelocatingVector(RelocatingVector&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    RelocatingVector& operator=(RelocatingVector&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        Clear();
+        std::free(data_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+        return *this;
+    }
+
+    ~RelocatingVector() {
+        Clear();
+        std::free(data_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == capacity_) {
+            Reserve(capacity_ ? capacity_ * 2 : 1);
+        }
+        T* slot = new (data_ + size_) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() {
+        --size_;
+        data_[size_].~T();
+    }
+
+    void Clear() {
+        for (size_t i = 0; i < size_; ++i) {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+
+    void Reserve(size_t capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+        if constexpr (kIsTriviallyRelocatable<T>) {
+            // Moving the bytes is a relocation for these types, which is what
+            // the cast to `void*` says (and what -Wclass-memaccess asks for)
+            void* data = std::realloc(static_cast<void*>(data_), capacity * sizeof(T));
+            if (!data) {
+                throw std::bad_alloc();
+            }
+            data_ = static_cast<T*>(data);
+        } else {
+            T* data = static_cast<T*>(std::malloc(capacity * sizeof(T)));
+            if (!data) {
+                throw std::bad_alloc();
+            }
+            for (size_t i = 0; i < size_; ++i) {
+                new (data + i) T(std::move(data_[i]));
+                data_[i].~T();
+            }
+            std::free(data_);
+            data_ = data;
+        }
+        capacity_ = capacity;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    T& operator[](size_t pos) {
+        return data_[pos];
+    }
+
+    const T& operator[](size_t pos) const {
+        return data_[pos];
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    T* begin() {
+        return data_;
+    }
+
+    T* end() {
+        return data_ + size_;
+    }
+
+    const T* begin() const {
+        return data_;
+    }
+
+    const T* end() const {
+        return data_ + size_;
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
@@ -0,0 +1,104 @@
+#include <common/accounting.h>
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+#include <shared-from-this/weak.h>
+
+#include <catch.hpp>
+
+#include <string>
+
+// Built with SMART_POINTERS_ACCOUNTING, see CMakeLists.txt
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Widget {
+    char data[40];
+};
+
+struct Gadget {
+    int value = 0;
+};
+
+struct Node : SimpleRefCounted<Node> {
+    long payload[4] = {};
+};
+
+struct Shared : AtomicRefCounted<Shared> {};
+
+}  // namespace
+
+static_assert(accounting::kEnabled);
+// The tracker adds no bytes in either build mode
+static_assert(sizeof(Node) == sizeof(SimpleCounter) + 4 * sizeof(long));
+
+TEST_CASE("Accounting for SharedPtr(new T)") {
+    {
+        SharedPtr<Widget> first(new Widget);
+        SharedPtr<Widget> second(new Widget);
+        auto stats = accounting::SnapshotOf<Widget>();
+        REQUIRE(stats.live_objects == 2);
+        REQUIRE(stats.live_bytes == 2 * sizeof(Widget));
+        REQUIRE(stats.live_overhead_bytes == 2 * sizeof(SimpleControlBlock<Widget>));
+
+        second.Reset();
+        stats = accounting::SnapshotOf<Widget>();
+        REQUIRE(stats.live_objects == 1);
+        REQUIRE(stats.peak_objects == 2);
+        REQUIRE(stats.peak_bytes == 2 * sizeof(Widget));
+    }
+    auto stats = accounting::SnapshotOf<Widget>();
+    REQUIRE(stats.live_objects == 0);
+    REQUIRE(stats.live_bytes == 0);
+    REQUIRE(stats.live_overhead_bytes == 0);
+    REQUIRE(stats.total_objects == 2);
+}
+
+TEST_CASE("Accounting for MakeShared and weak references") {
+    const size_t overhead = sizeof(ComplexControlBlock<Gadget>) - sizeof(Gadget);
+    WeakPtr<Gadget> weak;
+    {
+        auto shared = MakeShared<Gadget>();
+        weak = shared;
+        auto stats = accounting::SnapshotOf<Gadget>();
+        REQUIRE(stats.live_objects == 1);
+        REQUIRE(stats.live_overhead_bytes == overhead);
+    }
+    // The object is gone, the block stays for the weak reference
+    auto stats = accounting::SnapshotOf<Gadget>();
+    REQUIRE(stats.live_objects == 0);
+    REQUIRE(stats.live_bytes == 0);
+    REQUIRE(stats.live_overhead_bytes == overhead);
+
+    weak = WeakPtr<Gadget>();
+    REQUIRE(accounting::SnapshotOf<Gadget>().live_overhead_bytes == 0);
+}
+
+TEST_CASE("Accounting for RefCounted") {
+    {
+        auto first = MakeIntrusive<Node>();
+        auto second = first;
+        auto third = MakeIntrusive<Node>();
+        auto stats = accounting::SnapshotOf<Node>();
+        REQUIRE(stats.live_objects == 2);
+        REQUIRE(stats.live_bytes == 2 * sizeof(Node));
+        REQUIRE(stats.live_overhead_bytes == 2 * sizeof(SimpleCounter));
+    }
+    REQUIRE(accounting::SnapshotOf<Node>().live_objects == 0);
+
+    {
+        auto shared = MakeIntrusive<Shared>();
+        REQUIRE(accounting::SnapshotOf<Shared>().live_overhead_bytes == sizeof(AtomicCounter));
+    }
+    REQUIRE(accounting::SnapshotOf<Shared>().peak_objects == 1);
+}
+
+TEST_CASE("Accounting snapshot as JSON") {
+    SharedPtr<Widget> widget(new Widget);
+    auto json = accounting::ToJson(accounting::Snapshot());
+    REQUIRE(json.front() == '[');
+    REQUIRE(json.back() == ']');
+    REQUIRE(json.find("Widget\", \"live_objects\": 1") != std::string::npos);
+    REQUIRE(accounting::ToJson({}) == "[]");
+}
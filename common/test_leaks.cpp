@@ -0,0 +1,166 @@
+#include <common/leaks.h>
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+#include <shared-from-this/weak.h>
+
+#include <catch.hpp>
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Built with SMART_POINTERS_LEAKS, see CMakeLists.txt. Every test leaks on
+// purpose, checks the registry and cleans up, so the sanitizers stay quiet.
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Cycle {
+    SharedPtr<Cycle> next;
+};
+
+struct Lost {
+    long payload[8] = {};
+};
+
+struct Observed {
+    int value = 0;
+};
+
+struct Detached : AtomicRefCounted<Detached> {};
+
+struct Signalled {};
+
+template <typename T>
+std::vector<leaks::LiveObject> LiveOf() {
+    std::vector<leaks::LiveObject> result;
+    for (auto& object : leaks::LiveObjects()) {
+        if (object.type == TypeName<T>()) {
+            result.push_back(std::move(object));
+        }
+    }
+    return result;
+}
+
+std::string ReadAll(std::FILE* file) {
+    std::string text;
+    std::rewind(file);
+    char buffer[4096];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, read);
+    }
+    return text;
+}
+
+}  // namespace
+
+static_assert(leaks::kEnabled);
+
+TEST_CASE("Leaked SharedPtr cycle") {
+    Cycle* first;
+    {
+        auto a = MakeShared<Cycle>();
+        auto b = MakeShared<Cycle>();
+        a->next = b;
+        b->next = a;
+        first = a.Get();
+        REQUIRE(LiveOf<Cycle>().size() == 2);
+    }
+    auto live = LiveOf<Cycle>();
+    REQUIRE(live.size() == 2);
+    for (const auto& object : live) {
+        REQUIRE(object.counts.strong == 1);
+        REQUIRE(object.counts.weak == 0);
+        REQUIRE(object.size == sizeof(ComplexControlBlock<Cycle>));
+        REQUIRE(!object.stack.empty());
+    }
+
+    // Break the cycle
+    auto second = std::move(first->next);
+    second->next.Reset();
+    second.Reset();
+    REQUIRE(LiveOf<Cycle>().empty());
+}
+
+TEST_CASE("Leaked SharedPtr(new T)") {
+    auto* holder = new SharedPtr<Lost>(new Lost);
+    auto copy = *holder;
+    auto live = LiveOf<Lost>();
+    REQUIRE(live.size() == 1);
+    REQUIRE(live[0].address == static_cast<const void*>(holder->GetControlBlock()));
+    REQUIRE(live[0].counts.strong == 2);
+    REQUIRE(live[0].size == sizeof(SimpleControlBlock<Lost>) + sizeof(Lost));
+
+    copy.Reset();
+    REQUIRE(LiveOf<Lost>()[0].counts.strong == 1);
+    delete holder;
+    REQUIRE(LiveOf<Lost>().empty());
+}
+
+TEST_CASE("Block kept by WeakPtr") {
+    WeakPtr<Observed> weak;
+    {
+        auto shared = MakeShared<Observed>();
+        weak = shared;
+    }
+    auto live = LiveOf<Observed>();
+    REQUIRE(live.size() == 1);
+    REQUIRE(live[0].counts.strong == 0);
+    REQUIRE(live[0].counts.weak == 1);
+
+    weak = WeakPtr<Observed>();
+    REQUIRE(LiveOf<Observed>().empty());
+}
+
+TEST_CASE("Detached intrusive object") {
+    Detached* raw = MakeIntrusive<Detached>().Detach();
+    auto live = LiveOf<Detached>();
+    REQUIRE(live.size() == 1);
+    REQUIRE(live[0].address == static_cast<const void*>(raw));
+    REQUIRE(live[0].counts.strong == 1);
+    REQUIRE(live[0].size == sizeof(Detached));
+
+    IntrusivePtr<Detached>(raw, kAdoptRef).Reset();
+    REQUIRE(LiveOf<Detached>().empty());
+}
+
+TEST_CASE("Dump") {
+    auto a = MakeShared<Cycle>();
+    std::FILE* out = std::tmpfile();
+    REQUIRE(leaks::Dump(out) == leaks::LiveObjects().size());
+    auto text = ReadAll(out);
+    std::fclose(out);
+    REQUIRE(text.find(std::string(TypeName<Cycle>()) + ", ") != std::string::npos);
+    REQUIRE(text.find("strong 1, weak 0") != std::string::npos);
+    REQUIRE(text.find("    #0 ") != std::string::npos);
+}
+
+TEST_CASE("Dump on signal") {
+    auto object = MakeShared<Signalled>();
+    char path[] = "/tmp/test_leaks_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd != -1);
+    // Stays open for the dumping thread
+    leaks::DumpOnSignal(SIGUSR1, fdopen(fd, "w"));
+    REQUIRE(kill(getpid(), SIGUSR1) == 0);
+
+    std::string text;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (text.find(TypeName<Signalled>()) == std::string::npos &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::FILE* in = std::fopen(path, "r");
+        text = ReadAll(in);
+        std::fclose(in);
+    }
+    unlink(path);
+    REQUIRE(text.find(TypeName<Signalled>()) != std::string::npos);
+}
@@ -0,0 +1,153 @@
+#include <common/lifetime.h>
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+#include <shared-from-this/weak.h>
+
+#include <catch.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// Built with SMART_POINTERS_LIFETIME, see CMakeLists.txt
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+using namespace std::chrono_literals;
+
+struct Sample {};
+
+struct Raw {
+    int value = 0;
+};
+
+struct Made {
+    int value = 0;
+};
+
+struct Node : SimpleRefCounted<Node> {};
+
+struct Counted {};
+
+// Runs `body` and returns how long it took, an upper bound for any lifetime
+// recorded inside
+template <typename F>
+lifetime::Nanoseconds Elapsed(F body) {
+    auto start = lifetime::Clock::now();
+    body();
+    return lifetime::Clock::now() - start;
+}
+
+}  // namespace
+
+static_assert(lifetime::kEnabled);
+static_assert(lifetime::BucketIndex(0) == 0);
+static_assert(lifetime::BucketIndex(3) == 3);
+static_assert(lifetime::BucketIndex(4) == 4);
+static_assert(lifetime::BucketIndex(7) == 7);
+static_assert(lifetime::BucketIndex(8) == 8);
+static_assert(lifetime::BucketIndex(9) == 8);
+static_assert(lifetime::BucketIndex(10) == 9);
+static_assert(lifetime::BucketLowerBound(9) == 10);
+static_assert(lifetime::BucketIndex(uint64_t{1} << 60) == lifetime::kBuckets - 1);
+// The only cost per intrusive object is the birth timestamp
+static_assert(sizeof(Node) == sizeof(SimpleCounter) + sizeof(lifetime::Clock::time_point));
+
+TEST_CASE("Lifetime buckets") {
+    for (uint64_t ns = 0; ns < (uint64_t{1} << 20); ns += 1 + ns / 64) {
+        size_t index = lifetime::BucketIndex(ns);
+        REQUIRE(lifetime::BucketLowerBound(index) <= ns);
+        REQUIRE(ns < lifetime::BucketLowerBound(index + 1));
+        // Log-scale: a bucket is at most a quarter of its lower bound wide
+        if (ns >= lifetime::kSubBuckets) {
+            auto width = lifetime::BucketLowerBound(index + 1) - lifetime::BucketLowerBound(index);
+            REQUIRE(width * lifetime::kSubBuckets <= lifetime::BucketLowerBound(index));
+        }
+    }
+    for (size_t index = 0; index + 1 < lifetime::kBuckets; ++index) {
+        REQUIRE(lifetime::BucketIndex(lifetime::BucketLowerBound(index)) == index);
+    }
+}
+
+TEST_CASE("Lifetime quantiles") {
+    lifetime::Reset();
+    // 1us, 2us, ..., 10ms: every quantile is known exactly
+    constexpr size_t kCount = 10'000;
+    for (size_t i = 1; i <= kCount; ++i) {
+        lifetime::Record<Sample>(lifetime::Nanoseconds(i * 1000));
+    }
+    auto histogram = lifetime::HistogramOf<Sample>();
+    REQUIRE(histogram.count == kCount);
+    REQUIRE(histogram.max == 10ms);
+    REQUIRE(histogram.Mean() == lifetime::Nanoseconds(1000 * (kCount + 1) / 2));
+
+    for (double q : {0.01, 0.1, 0.5, 0.9, 0.99, 1.0}) {
+        double exact = (std::floor(q * (kCount - 1)) + 1) * 1000;
+        double estimate = static_cast<double>(histogram.Quantile(q).count());
+        // Half a bucket around the true value
+        REQUIRE(std::abs(estimate - exact) <= exact / 8);
+    }
+}
+
+TEST_CASE("Lifetime of SharedPtr(new T)") {
+    lifetime::Reset();
+    auto elapsed = Elapsed([] {
+        SharedPtr<Raw> first(new Raw);
+        SharedPtr<Raw> second = first;
+        std::this_thread::sleep_for(2ms);
+    });
+    auto histogram = lifetime::HistogramOf<Raw>();
+    REQUIRE(histogram.count == 1);
+    REQUIRE(histogram.max >= 2ms);
+    REQUIRE(histogram.max <= elapsed);
+}
+
+TEST_CASE("Lifetime of MakeShared ends with the object") {
+    lifetime::Reset();
+    WeakPtr<Made> weak;
+    auto elapsed = Elapsed([&weak] {
+        auto shared = MakeShared<Made>();
+        weak = shared;
+        std::this_thread::sleep_for(2ms);
+    });
+    // The control block lives on with the weak reference
+    std::this_thread::sleep_for(10ms);
+    REQUIRE(weak.Expired());
+    auto histogram = lifetime::HistogramOf<Made>();
+    REQUIRE(histogram.count == 1);
+    REQUIRE(histogram.max >= 2ms);
+    REQUIRE(histogram.max <= elapsed);
+}
+
+TEST_CASE("Lifetime of MakeIntrusive") {
+    lifetime::Reset();
+    auto elapsed = Elapsed([] {
+        auto node = MakeIntrusive<Node>();
+        std::this_thread::sleep_for(2ms);
+    });
+    auto histogram = lifetime::HistogramOf<Node>();
+    REQUIRE(histogram.count == 1);
+    REQUIRE(histogram.max >= 2ms);
+    REQUIRE(histogram.max <= elapsed);
+}
+
+TEST_CASE("Lifetime shards are merged") {
+    lifetime::Reset();
+    constexpr size_t kThreads = 12;
+    constexpr size_t kObjects = 1000;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kThreads; ++i) {
+        threads.emplace_back([] {
+            for (size_t j = 0; j < kObjects; ++j) {
+                SharedPtr<Counted> object(new Counted);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(lifetime::HistogramOf<Counted>().count == kThreads * kObjects);
+}
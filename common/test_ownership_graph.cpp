@@ -0,0 +1,192 @@
+#include <common/ownership_graph.h>
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// At namespace scope, so that type names in the expected output are the same
+// with every compiler
+
+struct ListNode {
+    SharedPtr<ListNode> next;
+    WeakPtr<ListNode> prev;
+};
+
+struct Texture {
+    char pixels[64] = {};
+};
+
+struct Mesh : SimpleRefCounted<Mesh> {
+    SharedPtr<Texture> texture;
+};
+
+struct Scene : SimpleRefCounted<Scene> {
+    std::vector<IntrusivePtr<Mesh>> meshes;
+};
+
+struct Blob {
+    char data[256] = {};
+};
+
+struct Shape {
+    virtual ~Shape() = default;
+};
+
+struct Polygon : Shape {
+    double points[32] = {};
+};
+
+namespace {
+
+void RegisterTraces() {
+    ownership::RegisterTrace<ListNode>([](const ListNode& node, ownership::Tracer& tracer) {
+        tracer.Edge(node.next, "next");
+        tracer.Edge(node.prev, "prev");
+    });
+    ownership::RegisterTrace<Mesh>([](const Mesh& mesh, ownership::Tracer& tracer) {
+        tracer.Edge(mesh.texture, "texture");
+    });
+    ownership::RegisterTrace<Scene>([](const Scene& scene, ownership::Tracer& tracer) {
+        for (const auto& mesh : scene.meshes) {
+            tracer.Edge(mesh);
+        }
+    });
+}
+
+std::string Size(size_t size) {
+    return std::to_string(size);
+}
+
+}  // namespace
+
+TEST_CASE("Ownership of a doubly linked list") {
+    RegisterTraces();
+    auto first = MakeShared<ListNode>();
+    auto second = MakeShared<ListNode>();
+    first->next = second;
+    second->prev = first;
+
+    ownership::Tracer tracer;
+    tracer.Root("head", first);
+    const auto& graph = tracer.GetGraph();
+    REQUIRE(graph.nodes.size() == 2);
+    REQUIRE(graph.nodes[0].address == first.GetControlBlock());
+    REQUIRE(graph.nodes[1].address == second.GetControlBlock());
+
+    // The walk must not leave its own references behind
+    REQUIRE(first.UseCount() == 1);
+    REQUIRE(second.UseCount() == 2);
+
+    auto block = Size(sizeof(ComplexControlBlock<ListNode>));
+    REQUIRE(graph.ToDot() ==
+            "digraph ownership {\n"
+            "    root0 [shape=plaintext, label=\"head\"];\n"
+            "    n0 [shape=box, label=\"ListNode\\n" + block + " bytes, strong 1, weak 1\"];\n"
+            "    n1 [shape=box, label=\"ListNode\\n" + block + " bytes, strong 2, weak 0\"];\n"
+            "    root0 -> n0;\n"
+            "    n0 -> n1 [label=\"next\"];\n"
+            "    n1 -> n0 [style=dashed, label=\"prev\"];\n"
+            "}\n");
+}
+
+TEST_CASE("Ownership of intrusive objects with shared resources") {
+    RegisterTraces();
+    auto texture = SharedPtr<Texture>(new Texture);
+    auto shared_mesh = MakeIntrusive<Mesh>();
+    shared_mesh->texture = texture;
+    auto scene = MakeIntrusive<Scene>();
+    scene->meshes = {shared_mesh, MakeIntrusive<Mesh>(), shared_mesh};
+    texture.Reset();
+
+    ownership::Tracer tracer;
+    tracer.Root("scene", scene);
+    auto texture_size = Size(sizeof(SimpleControlBlock<Texture>) + sizeof(Texture));
+    REQUIRE(tracer.GetGraph().ToJson() ==
+            "{\n"
+            "  \"nodes\": [\n"
+            "    {\"id\": 0, \"type\": \"Scene\", \"size\": " + Size(sizeof(Scene)) +
+            ", \"strong\": 1, \"weak\": 0},\n"
+            "    {\"id\": 1, \"type\": \"Mesh\", \"size\": " + Size(sizeof(Mesh)) +
+            ", \"strong\": 3, \"weak\": 0},\n"
+            "    {\"id\": 2, \"type\": \"Mesh\", \"size\": " + Size(sizeof(Mesh)) +
+            ", \"strong\": 1, \"weak\": 0},\n"
+            "    {\"id\": 3, \"type\": \"Texture\", \"size\": " + texture_size +
+            ", \"strong\": 1, \"weak\": 0}\n"
+            "  ],\n"
+            "  \"roots\": [\n"
+            "    {\"name\": \"scene\", \"to\": 0, \"kind\": \"strong\"}\n"
+            "  ],\n"
+            "  \"edges\": [\n"
+            "    {\"from\": 0, \"to\": 1, \"kind\": \"strong\", \"label\": \"\"},\n"
+            "    {\"from\": 0, \"to\": 2, \"kind\": \"strong\", \"label\": \"\"},\n"
+            "    {\"from\": 0, \"to\": 1, \"kind\": \"strong\", \"label\": \"\"},\n"
+            "    {\"from\": 1, \"to\": 3, \"kind\": \"strong\", \"label\": \"texture\"}\n"
+            "  ]\n"
+            "}\n");
+}
+
+TEST_CASE("Weak references retain MakeShared storage") {
+    WeakPtr<Blob> from_make_shared = MakeShared<Blob>();
+    WeakPtr<Blob> from_new = SharedPtr<Blob>(new Blob);
+
+    ownership::Tracer tracer;
+    tracer.Root("cache", from_make_shared);
+    tracer.Root("index", from_new);
+    const auto& graph = tracer.GetGraph();
+    REQUIRE(graph.nodes.size() == 2);
+    // The object is gone, but its bytes are part of the block
+    REQUIRE(graph.nodes[0].size == sizeof(ComplexControlBlock<Blob>));
+    REQUIRE(graph.nodes[0].size > sizeof(Blob));
+    REQUIRE(graph.nodes[1].size == sizeof(SimpleControlBlock<Blob>));
+    REQUIRE(graph.nodes[1].strong == 0);
+
+    auto dot = graph.ToDot();
+    REQUIRE(dot.find("    n0 [shape=box, style=dashed, label=\"Blob\\n") != std::string::npos);
+    REQUIRE(dot.find("    root0 -> n0 [style=dashed];\n") != std::string::npos);
+    REQUIRE(dot.find("    root1 -> n1 [style=dashed];\n") != std::string::npos);
+}
+
+TEST_CASE("Strong cycles and shared roots") {
+    RegisterTraces();
+    auto first = MakeShared<ListNode>();
+    auto second = MakeShared<ListNode>();
+    first->next = second;
+    second->next = first;
+
+    ownership::Tracer tracer;
+    tracer.Root("first", first);
+    tracer.Root("second", second);
+    tracer.Root("empty", SharedPtr<ListNode>());
+    const auto& graph = tracer.GetGraph();
+    REQUIRE(graph.nodes.size() == 2);
+    REQUIRE(graph.roots.size() == 2);
+    REQUIRE(graph.roots[1].to == 1);
+    REQUIRE(graph.edges.size() == 2);
+    REQUIRE(graph.edges[1].from == 1);
+    REQUIRE(graph.edges[1].to == 0);
+
+    second->next.Reset();
+}
+
+TEST_CASE("Nodes are sized by their block, not by the pointer type") {
+    SharedPtr<Shape> made = MakeShared<Polygon>();
+    SharedPtr<Shape> adopted(new Polygon);
+
+    ownership::Tracer tracer;
+    tracer.Root("made", made);
+    tracer.Root("adopted", adopted);
+    const auto& graph = tracer.GetGraph();
+    REQUIRE(graph.nodes.size() == 2);
+    REQUIRE(graph.nodes[0].size == sizeof(ComplexControlBlock<Polygon>));
+    REQUIRE(graph.nodes[1].size == sizeof(SimpleControlBlock<Polygon>) + sizeof(Polygon));
+}
+
+TEST_CASE("Empty graph") {
+    ownership::Tracer tracer;
+    REQUIRE(tracer.GetGraph().ToDot() == "digraph ownership {\n}\n");
+    REQUIRE(tracer.GetGraph().ToJson() ==
+            "{\n  \"nodes\": [],\n  \"roots\": [],\n  \"edges\": []\n}\n");
+}
@@ -0,0 +1,102 @@
+#include <common/profiling.h>
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+
+#include <catch.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Built with SMART_POINTERS_PROFILING, see CMakeLists.txt
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct HotConfig : AtomicRefCounted<HotConfig> {};
+
+struct ColdItem : AtomicRefCounted<ColdItem> {};
+
+struct Document {
+    int revision = 0;
+};
+
+}  // namespace
+
+static_assert(profiling::kEnabled);
+
+TEST_CASE("Profiler finds the object shared between threads") {
+    profiling::SetSampleRate(1);
+    profiling::Reset();
+
+    auto hot = MakeIntrusive<HotConfig>();
+    // Alive until the end, so no two of them share an address, which would
+    // merge them into one object in the report
+    std::vector<IntrusivePtr<ColdItem>> colds;
+    for (int t = 0; t < 4; ++t) {
+        colds.push_back(MakeIntrusive<ColdItem>());
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([hot, &cold = colds[t]] {
+            for (int i = 0; i < 1000; ++i) {
+                IntrusivePtr<HotConfig> copy(hot);
+                IntrusivePtr<ColdItem> other(cold);
+            }
+        });
+    }
+    // Exiting threads hand over their buffered samples
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto report = profiling::HottestObjects(3);
+    REQUIRE(report.size() == 3);
+    REQUIRE(report[0].address == hot.Get());
+    REQUIRE(std::string(report[0].type).find("HotConfig") != std::string::npos);
+    REQUIRE(report[0].threads == 5);  // four workers and this one
+    REQUIRE(report[0].samples >= 8000);
+    REQUIRE(report[1].threads == 2);  // its worker and this one, which created it
+    REQUIRE(std::string(report[1].type).find("ColdItem") != std::string::npos);
+
+    profiling::SetSampleRate(profiling::kDefaultSampleRate);
+}
+
+TEST_CASE("Profiler samples control blocks") {
+    profiling::SetSampleRate(1);
+    profiling::Reset();
+
+    auto document = MakeShared<Document>();
+    for (int i = 0; i < 10; ++i) {
+        SharedPtr<Document> copy(document);
+    }
+    auto report = profiling::HottestObjects();
+    REQUIRE(report.size() == 1);
+    REQUIRE(report[0].address == document.GetControlBlock());
+    REQUIRE(report[0].samples == 21);  // creation and ten copies, each up and down
+    REQUIRE(std::string(report[0].type).find("Document") != std::string::npos);
+
+    profiling::SetSampleRate(profiling::kDefaultSampleRate);
+}
+
+TEST_CASE("Sampling rate") {
+    auto config = MakeIntrusive<HotConfig>();
+    profiling::SetSampleRate(100);
+    profiling::Reset();
+    for (int i = 0; i < 10'000; ++i) {
+        IntrusivePtr<HotConfig> copy(config);
+    }
+    auto report = profiling::HottestObjects();
+    REQUIRE(report.size() == 1);
+    REQUIRE(report[0].samples == 200);
+
+    profiling::SetSampleRate(0);
+    profiling::Reset();
+    for (int i = 0; i < 10'000; ++i) {
+        IntrusivePtr<HotConfig> copy(config);
+    }
+    REQUIRE(profiling::HottestObjects().empty());
+
+    profiling::SetSampleRate(profiling::kDefaultSampleRate);
+}
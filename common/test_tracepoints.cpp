@@ -0,0 +1,61 @@
+#include <common/tracepoints.h>
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+#include <shared-from-this/weak.h>
+
+#include <catch.hpp>
+
+#include <string_view>
+
+// Built without SMART_POINTERS_TRACEPOINTS: the probes must vanish
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Node : SimpleRefCounted<Node> {};
+
+int evaluations = 0;
+
+// Only ever named inside disabled probes, so never odr-used
+[[maybe_unused]] int Touch() {
+    return ++evaluations;
+}
+
+}  // namespace
+
+static_assert(!tracepoints::kEnabled);
+// Usable as a statement anywhere, including constant evaluation
+static_assert([] {
+    SMART_POINTERS_TRACE(never, Touch());
+    return true;
+}());
+static_assert(std::string_view(tracepoints::TypeNameOf<int>()) == "int");
+
+TEST_CASE("Disabled probes do not evaluate their arguments") {
+    SMART_POINTERS_TRACE(never, Touch(), Touch());
+    if (evaluations == 0)
+        SMART_POINTERS_TRACE(never, Touch());
+    else
+        SMART_POINTERS_TRACE(never, Touch());
+    REQUIRE(evaluations == 0);
+}
+
+TEST_CASE("Probe sites work with probes compiled out") {
+    WeakPtr<int> weak;
+    {
+        auto shared = MakeShared<int>(42);
+        weak = shared;
+        REQUIRE(weak.Lock().UseCount() == 2);
+    }
+    REQUIRE(!weak.Lock());
+
+    auto node = MakeIntrusive<Node>();
+    auto copy = node;
+    copy.Reset();
+    REQUIRE(node->RefCount() == 1);
+}
+
+TEST_CASE("Type names for probes") {
+    REQUIRE(std::string_view(tracepoints::TypeNameOf<Node>()) == TypeName<Node>());
+}
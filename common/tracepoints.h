@@ -0,0 +1,75 @@
+#pragma once
+
+#include "type_name.h"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+// Opt-in build mode (-DSMART_POINTERS_TRACEPOINTS, CMake option of the same
+// name): USDT probes (provider `smart_pointers`) on the lifecycle of shared and
+// intrusive objects, for `perf` and `bpftrace` to attach to in a running
+// process. A probe that nobody listens to is a single `nop`, but its arguments
+// are still computed. Needs <sys/sdt.h> from systemtap (systemtap-sdt-dev on
+// Debian, systemtap-sdt-devel on Fedora); it is only a header.
+//
+// Without the option `SMART_POINTERS_TRACE` expands to nothing and its
+// arguments are not evaluated, like `assert` under NDEBUG.
+//
+// Probes and their arguments:
+//   subscribe(block, strong count after, type)    a SharedPtr took a strong
+//                                                 reference; count 1 is a new
+//                                                 object
+//   unsubscribe(block, strong count after, type)  a SharedPtr dropped one;
+//                                                 count 0 destroys the object
+//   block_free(block)                             the control block is deleted
+//   lock_failed(block, type)                      `WeakPtr::Lock` on an expired
+//                                                 (or empty) pointer
+//   intrusive_release(object, count after, type)  `RefCounted::DecRef`; count 0
+//                                                 destroys the object
+// `type` is a NUL-terminated type name, e.g. `str(arg2)` in bpftrace.
+// See common/tracepoints.bt for an example script.
+
+#ifdef SMART_POINTERS_TRACEPOINTS
+
+#if !__has_include(<sys/sdt.h>)
+#error "SMART_POINTERS_TRACEPOINTS needs <sys/sdt.h>, install systemtap-sdt-dev"
+#endif
+
+#include <sys/sdt.h>
+
+#define HAS_TRACEPOINTS 1
+#define SMART_POINTERS_TRACE(name, ...) STAP_PROBEV(smart_pointers, name, __VA_ARGS__)
+
+#else
+
+#define HAS_TRACEPOINTS 0
+#define SMART_POINTERS_TRACE(name, ...) static_cast<void>(0)
+
+#endif
+
+namespace tracepoints {
+
+inline constexpr bool kEnabled = HAS_TRACEPOINTS;
+
+namespace detail {
+
+template <typename T>
+inline constexpr auto kTypeName = [] {
+    constexpr std::string_view name = TypeName<T>();
+    std::array<char, name.size() + 1> result{};
+    for (size_t i = 0; i < name.size(); ++i) {
+        result[i] = name[i];
+    }
+    return result;
+}();
+
+}  // namespace detail
+
+// NUL-terminated, for probe arguments
+template <typename T>
+constexpr const char* TypeNameOf() {
+    return detail::kTypeName<T>.data();
+}
+
+}  // namespace tracepoints
@@ -0,0 +1,76 @@
+#include <intrusive/intrusive.h>
+#include <shared-from-this/shared.h>
+#include <shared-from-this/weak.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Sample binary for the USDT probes, built with SMART_POINTERS_TRACEPOINTS.
+// Every round creates and drops a few shared and intrusive objects and fails a
+// known number of `WeakPtr::Lock`-s, then sleeps, so a tracer has time to
+// attach. See common/tracepoints.bt.
+//
+//   ./tracepoints_example [--rounds=N]
+
+namespace {
+
+struct Session {
+    int id = 0;
+};
+
+struct Request : AtomicRefCounted<Request> {
+    explicit Request(int id) : id(id) {
+    }
+
+    int id;
+};
+
+constexpr int kSessionsPerRound = 8;
+constexpr int kRequestsPerRound = 16;
+
+void Round() {
+    std::vector<WeakPtr<Session>> observers;
+    {
+        std::vector<SharedPtr<Session>> sessions;
+        for (int i = 0; i < kSessionsPerRound; ++i) {
+            sessions.push_back(MakeShared<Session>(Session{i}));
+            observers.emplace_back(sessions.back());
+        }
+        // Keep every other session alive until the end of the round
+        for (int i = 0; i < kSessionsPerRound; i += 2) {
+            observers[i].Lock();
+        }
+    }
+    // Every session is gone: each of these is a lock_failed
+    for (const auto& observer : observers) {
+        observer.Lock();
+    }
+
+    std::vector<IntrusivePtr<Request>> requests;
+    for (int i = 0; i < kRequestsPerRound; ++i) {
+        requests.push_back(MakeIntrusive<Request>(i));
+    }
+    auto copies = requests;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int rounds = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--rounds=", 9) == 0) {
+            rounds = std::atoi(argv[i] + 9);
+        }
+    }
+    for (int round = 0; round < rounds; ++round) {
+        Round();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    std::printf("%d rounds: %d sessions, %d failed locks, %d requests\n", rounds,
+                rounds * kSessionsPerRound, rounds * kSessionsPerRound,
+                rounds * kRequestsPerRound);
+}
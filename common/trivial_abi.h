@@ -0,0 +1,18 @@
+#pragma once
+
+// Opt-in build mode (-DSMART_POINTERS_TRIVIAL_ABI, CMake option of the same name):
+// mark owning pointers `[[clang::trivial_abi]]` so they are passed and returned
+// in registers despite the non-trivial destructor. The catch is that a by-value
+// parameter is then destroyed by the callee, at the end of the call, instead of
+// by the caller. Other compilers ignore the option.
+#if defined(SMART_POINTERS_TRIVIAL_ABI) && defined(__has_cpp_attribute)
+#if __has_cpp_attribute(clang::trivial_abi)
+#define TRIVIAL_ABI [[clang::trivial_abi]]
+#define HAS_TRIVIAL_ABI 1
+#endif
+#endif
+
+#ifndef TRIVIAL_ABI
+#define TRIVIAL_ABI
+#define HAS_TRIVIAL_ABI 0
+#endif
@@ -0,0 +1,51 @@
+# Checks that UniquePtr and IntrusivePtr parameters are passed in a register
+# exactly when trivial_abi mode is in effect, by compiling
+# trivial_abi_probe.cpp to x86-64 assembly. Run by ctest, see CMakeLists.txt:
+#
+#   cmake -DCXX=<compiler> -DSOURCE_DIR=<repository> -DOUTPUT=<file.s>
+#         [-DTRIVIAL_ABI=ON] -P common/trivial_abi_codegen.cmake
+
+set(flags -std=c++20 -O2 -S -I${SOURCE_DIR})
+if (TRIVIAL_ABI)
+    list(APPEND flags -DSMART_POINTERS_TRIVIAL_ABI)
+endif()
+execute_process(
+    COMMAND ${CXX} ${flags} ${SOURCE_DIR}/common/trivial_abi_probe.cpp -o ${OUTPUT}
+    RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Failed to compile trivial_abi_probe.cpp")
+endif()
+file(READ ${OUTPUT} assembly)
+
+string(FIND "${assembly}" "ProbeTrivialAbiEnabled:" enabled)
+if (enabled EQUAL -1)
+    set(expected "memory")
+else()
+    set(expected "register")
+endif()
+
+# The first argument register is only dereferenced when it holds the address
+# of the caller's temporary
+function(check_parameter function)
+    string(FIND "${assembly}" "${function}:" begin)
+    if (begin EQUAL -1)
+        message(FATAL_ERROR "${function} not found in ${OUTPUT}")
+    endif()
+    string(SUBSTRING "${assembly}" ${begin} -1 body)
+    string(FIND "${body}" ".cfi_endproc" end)
+    string(SUBSTRING "${body}" 0 ${end} body)
+    string(FIND "${body}" "(%rdi)" load)
+    if (load EQUAL -1)
+        set(actual "register")
+    else()
+        set(actual "memory")
+    endif()
+    if (NOT actual STREQUAL expected)
+        message(FATAL_ERROR "${function}: parameter passed in ${actual}, "
+                            "expected ${expected}:\n${body}")
+    endif()
+    message(STATUS "${function}: parameter passed in ${actual}")
+endfunction()
+
+check_parameter(ProbeUniqueRelease)
+check_parameter(ProbeIntrusiveDetach)
@@ -0,0 +1,26 @@
+#include <intrusive/intrusive.h>
+#include <unique/unique.h>
+
+// Not part of any target: trivial_abi_codegen.cmake compiles this file to
+// assembly and checks how the by-value parameters below are passed. In a
+// register, releasing the pointer is a register move; in memory, the callee
+// loads the pointer from the caller's temporary and clears it there.
+
+struct Probe : SimpleRefCounted<Probe> {};
+
+extern "C" {
+
+int* ProbeUniqueRelease(UniquePtr<int> ptr) {
+    return ptr.Release();
+}
+
+Probe* ProbeIntrusiveDetach(IntrusivePtr<Probe> ptr) {
+    return ptr.Detach();
+}
+
+#if HAS_TRIVIAL_ABI
+// Present when the compiler applied the attribute, which decides what to expect
+void ProbeTrivialAbiEnabled() {
+}
+#endif
+}
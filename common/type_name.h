@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string_view>
+
+// Human-readable name of `T` taken from the compiler's pretty function name,
+// so it works with RTTI disabled and needs no demangling:
+// `TypeName<std::string>()` is "std::__cxx11::basic_string<char>" on GCC.
+template <typename T>
+constexpr std::string_view TypeName() {
+#if defined(__clang__) || defined(__GNUC__)
+    std::string_view name = __PRETTY_FUNCTION__;
+    // "... TypeName() [with T = int; ...]" (GCC) or "... TypeName() [T = int]" (Clang)
+    auto begin = name.find("T = ") + 4;
+    auto end = name.find_first_of(";]", begin);
+    return name.substr(begin, end - begin);
+#else
+    return "unknown";
+#endif
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Slot holding an `IntrusivePtr` that many threads may load and store
+// concurrently without locks. `T` must use a thread-safe counter supporting
+// `IncRef(count)`, e.g. `AtomicRefCounted`.
+//
+// A plain `std::atomic<T*>` plus `IncRef` is not enough: the last owner may
+// destroy the object between the load and the increment. Here the slot keeps
+// a split count: the high 16 bits of the word count readers that loaded the
+// pointer but have not taken their own reference yet. The slot's own reference
+// keeps the object alive for them; whoever replaces the pointer converts the
+// pending reader count into real references before dropping the slot's one.
+template <typename T>
+class AtomicIntrusivePtr {
+    static_assert(sizeof(void*) == sizeof(uint64_t), "Split count needs 64-bit pointers");
+
+public:
+    AtomicIntrusivePtr() : slot_(0) {
+    }
+
+    AtomicIntrusivePtr(IntrusivePtr<T> ptr) : slot_(Pack(ptr.Detach())) {
+    }
+
+    AtomicIntrusivePtr(const AtomicIntrusivePtr&) = delete;
+    AtomicIntrusivePtr& operator=(const AtomicIntrusivePtr&) = delete;
+
+    ~AtomicIntrusivePtr() {
+        if (T* ptr = Pointer(slot_.load(std::memory_order_relaxed))) {
+            ptr->DecRef();
+        }
+    }
+
+    IntrusivePtr<T> Load() const {
+        if (!Pointer(slot_.load(std::memory_order_acquire))) {
+            return nullptr;
+        }
+        uint64_t word = slot_.fetch_add(kOneReader, std::memory_order_acquire) + kOneReader;
+        T* ptr = Pointer(word);
+        if (!ptr) {
+            ReturnReader(word);
+            return nullptr;
+        }
+        ptr->IncRef();
+        if (!ReturnReader(word)) {
+            // The writer who replaced `ptr` has already turned our pending
+            // read into a reference, so one of the two must go
+            ptr->DecRef();
+        }
+        return AdoptRef(ptr);
+    }
+
+    void Store(IntrusivePtr<T> desired) {
+        Exchange(std::move(desired));
+    }
+
+    IntrusivePtr<T> Exchange(IntrusivePtr<T> desired) {
+        uint64_t old = slot_.exchange(Pack(desired.Detach()), std::memory_order_acq_rel);
+        return Retire(old);
+    }
+
+    // On failure `expected` is updated with the current value
+    bool CompareExchange(IntrusivePtr<T>& expected, IntrusivePtr<T> desired) {
+        uint64_t word = slot_.load(std::memory_order_acquire);
+        while (Pointer(word) == expected.Get()) {
+            if (slot_.compare_exchange_weak(word, Pack(desired.Get()),
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+                desired.Detach();
+                Retire(word);
+                return true;
+            }
+        }
+        expected = Load();
+        return false;
+    }
+
+    bool IsLockFree() const {
+        return slot_.is_lock_free();
+    }
+
+private:
+    static constexpr int kPointerBits = 48;
+    static constexpr uint64_t kPointerMask = (uint64_t{1} << kPointerBits) - 1;
+    static constexpr uint64_t kOneReader = uint64_t{1} << kPointerBits;
+
+    static uint64_t Pack(T* ptr) {
+        return reinterpret_cast<uint64_t>(ptr);
+    }
+
+    static T* Pointer(uint64_t word) {
+        return reinterpret_cast<T*>(word & kPointerMask);
+    }
+
+    static uint64_t Readers(uint64_t word) {
+        return word >> kPointerBits;
+    }
+
+    // Give back the pending read counted in `word`. Fails if the pointer was
+    // replaced in the meantime. If the same pointer was stored again, taking
+    // another reader's pending read is fine: the references are on the same
+    // object, so the totals still add up.
+    bool ReturnReader(uint64_t word) const {
+        T* ptr = Pointer(word);
+        word = slot_.load(std::memory_order_relaxed);
+        while (Pointer(word) == ptr && Readers(word) > 0) {
+            if (slot_.compare_exchange_weak(word, word - kOneReader, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Take over the slot's reference to a value that was just replaced
+    static IntrusivePtr<T> Retire(uint64_t word) {
+        T* ptr = Pointer(word);
+        if (!ptr) {
+            return nullptr;
+        }
+        if (uint64_t readers = Readers(word)) {
+            ptr->IncRef(readers);
+        }
+        return AdoptRef(ptr);
+    }
+
+    mutable std::atomic<uint64_t> slot_;
+};
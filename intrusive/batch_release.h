@@ -0,0 +1,162 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <algorithm>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Bulk release of `IntrusivePtr`s. Instead of running `DecRef` (and possibly
+// the destructor) element by element, the counts are decremented in one tight
+// loop with prefetching, and the dead objects are destroyed in a second pass,
+// either block by block or on a background thread.
+//
+// Types without `DecRefNoDestroy()`/`Destroy()` (custom counters) fall back
+// to a plain `DecRef()` in the first pass.
+
+template <typename T>
+inline constexpr bool kHasDeferredDestroy = requires(T* object) {
+    { object->DecRefNoDestroy() } -> std::same_as<bool>;
+    object->Destroy();
+};
+
+inline constexpr size_t kReleasePrefetchDistance = 16;
+
+// Empties `ptrs` and appends the objects whose last reference was dropped to `dead`
+template <typename T>
+void DecRefAll(std::span<IntrusivePtr<T>> ptrs, std::vector<T*>& dead) {
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+#if defined(__GNUC__)
+        if (i + kReleasePrefetchDistance < ptrs.size()) {
+            __builtin_prefetch(ptrs[i + kReleasePrefetchDistance].Get(), 1);
+        }
+#endif
+        T* object = ptrs[i].Detach();
+        if (!object) {
+            continue;
+        }
+        if constexpr (kHasDeferredDestroy<T>) {
+            if (object->DecRefNoDestroy()) {
+                dead.push_back(object);
+            }
+        } else {
+            object->DecRef();
+        }
+    }
+}
+
+template <typename T>
+std::vector<T*> DecRefAll(std::span<IntrusivePtr<T>> ptrs) {
+    std::vector<T*> dead;
+    DecRefAll(ptrs, dead);
+    return dead;
+}
+
+template <typename T>
+void DestroyAll(const std::vector<T*>& dead) {
+    for (T* object : dead) {
+        object->Destroy();
+    }
+}
+
+// Works in blocks small enough for the dead objects of a block to still be
+// in cache when they are destroyed
+template <typename T>
+void ReleaseAll(std::span<IntrusivePtr<T>> ptrs) {
+    constexpr size_t kBlockSize = 64;
+
+    std::vector<T*> dead;
+    dead.reserve(kBlockSize);
+    for (size_t begin = 0; begin < ptrs.size(); begin += kBlockSize) {
+        DecRefAll(ptrs.subspan(begin, std::min(kBlockSize, ptrs.size() - begin)), dead);
+        DestroyAll(dead);
+        dead.clear();
+    }
+}
+
+template <typename T>
+void ReleaseAll(std::vector<IntrusivePtr<T>>& ptrs) {
+    ReleaseAll(std::span<IntrusivePtr<T>>(ptrs));
+    ptrs.clear();
+}
+
+// Runs the destruction pass on its own thread. Counts are still decremented
+// by the caller, so the pointers are empty as soon as `ReleaseAll` returns;
+// only the destructors (and `Deleter`) must be safe to run on another thread.
+class BackgroundReleaser {
+public:
+    BackgroundReleaser() : worker_([this] { Work(); }) {
+    }
+
+    BackgroundReleaser(const BackgroundReleaser&) = delete;
+    BackgroundReleaser& operator=(const BackgroundReleaser&) = delete;
+
+    // Destroys everything still pending
+    ~BackgroundReleaser() {
+        {
+            std::lock_guard guard(mutex_);
+            stop_ = true;
+        }
+        has_work_.notify_one();
+        worker_.join();
+    }
+
+    template <typename T>
+    void ReleaseAll(std::span<IntrusivePtr<T>> ptrs) {
+        auto dead = DecRefAll(ptrs);
+        if (dead.empty()) {
+            return;
+        }
+        {
+            std::lock_guard guard(mutex_);
+            tasks_.emplace_back([dead = std::move(dead)] { DestroyAll(dead); });
+        }
+        has_work_.notify_one();
+    }
+
+    template <typename T>
+    void ReleaseAll(std::vector<IntrusivePtr<T>>& ptrs) {
+        ReleaseAll(std::span<IntrusivePtr<T>>(ptrs));
+        ptrs.clear();
+    }
+
+    // Waits until everything released so far is destroyed
+    void Flush() {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+    }
+
+private:
+    void Work() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            has_work_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            busy_ = true;
+            lock.unlock();
+            task();
+            lock.lock();
+            busy_ = false;
+            idle_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable has_work_;
+    std::condition_variable idle_;
+    std::deque<std::function<void()>> tasks_;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::thread worker_;
+};
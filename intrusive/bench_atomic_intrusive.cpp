@@ -0,0 +1,85 @@
+#include "atomic_intrusive.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// AtomicIntrusivePtr vs std::mutex + IntrusivePtr: read scaling with one writer
+
+struct Config : AtomicRefCounted<Config> {
+    Config(int value) : value{value} {
+    }
+
+    int value;
+};
+
+class LockedSlot {
+public:
+    explicit LockedSlot(IntrusivePtr<Config> ptr) : ptr_(std::move(ptr)) {
+    }
+
+    IntrusivePtr<Config> Load() const {
+        std::lock_guard guard(mutex_);
+        return ptr_;
+    }
+
+    void Store(IntrusivePtr<Config> ptr) {
+        std::lock_guard guard(mutex_);
+        ptr_.Swap(ptr);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    IntrusivePtr<Config> ptr_;
+};
+
+template <typename Slot>
+double Run(int readers_count, std::chrono::milliseconds duration) {
+    Slot slot(MakeIntrusive<Config>(0));
+    std::atomic<bool> stop = false;
+    std::atomic<int64_t> total_reads = 0;
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < readers_count; ++i) {
+        readers.emplace_back([&] {
+            int64_t reads = 0;
+            int64_t sum = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                sum += slot.Load()->value;
+                ++reads;
+            }
+            total_reads += reads + (sum == -1);
+        });
+    }
+    std::thread writer([&] {
+        for (int version = 1; !stop.load(std::memory_order_relaxed); ++version) {
+            slot.Store(MakeIntrusive<Config>(version));
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    writer.join();
+
+    return total_reads / std::chrono::duration<double>(duration).count() / 1e6;
+}
+
+int main() {
+    constexpr std::chrono::milliseconds kDuration(300);
+
+    std::printf("%-10s %16s %16s\n", "readers", "atomic Mreads/s", "mutex Mreads/s");
+    for (int readers = 1; readers <= 64; readers *= 2) {
+        double lock_free = Run<AtomicIntrusivePtr<Config>>(readers, kDuration);
+        double locked = Run<LockedSlot>(readers, kDuration);
+        std::printf("%-10d %16.2f %16.2f\n", readers, lock_free, locked);
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "batch_release.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Teardown of a large std::vector<IntrusivePtr<T>>: element-wise vs ReleaseAll
+
+struct Payload : SimpleRefCounted<Payload> {
+    char data[48];
+};
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<IntrusivePtr<Payload>> MakePointers(size_t count, bool shuffle) {
+    std::vector<IntrusivePtr<Payload>> ptrs;
+    ptrs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        ptrs.push_back(MakeIntrusive<Payload>());
+    }
+    if (shuffle) {
+        std::shuffle(ptrs.begin(), ptrs.end(), std::mt19937(42));
+    }
+    return ptrs;
+}
+
+// Best of a few runs: the first teardown in a process also pays for the
+// allocator trimming fresh memory, which would skew whichever variant runs first
+template <typename Release, typename Finish>
+double Measure(size_t count, bool shuffle, Release release, Finish finish) {
+    constexpr int kRepetitions = 3;
+
+    double best = 0;
+    for (int i = 0; i < kRepetitions; ++i) {
+        auto ptrs = MakePointers(count, shuffle);
+        auto start = Clock::now();
+        release(ptrs);
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        finish();
+        best = i == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+int main() {
+    constexpr size_t kCount = 10'000'000;
+
+    std::printf("%-10s %14s %14s %18s\n", "order", "clear() ms", "ReleaseAll ms",
+                "background ms");
+    for (bool shuffle : {false, true}) {
+        auto nothing = [] {};
+        double plain = Measure(kCount, shuffle, [](auto& ptrs) { ptrs.clear(); }, nothing);
+        double batched = Measure(kCount, shuffle, [](auto& ptrs) { ReleaseAll(ptrs); }, nothing);
+
+        // Caller-side time only, the destruction pass runs on the releaser thread
+        BackgroundReleaser releaser;
+        double background = Measure(
+            kCount, shuffle, [&releaser](auto& ptrs) { releaser.ReleaseAll(ptrs); },
+            [&releaser] { releaser.Flush(); });
+
+        std::printf("%-10s %14.1f %14.1f %18.1f\n", shuffle ? "shuffled" : "sequential", plain,
+                    batched, background);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "intrusive_hash_set.h"
+#include "intrusive_list.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// LRU cache on intrusive hooks vs std::list + std::unordered_map of IntrusivePtr
+
+struct Entry : SimpleRefCounted<Entry>, ListHook<>, HashSetHook<> {
+    Entry(uint64_t key) : key{key}, value{key * 31} {
+    }
+
+    uint64_t key;
+    uint64_t value;
+};
+
+struct EntryKey {
+    uint64_t operator()(const Entry& entry) const {
+        return entry.key;
+    }
+};
+
+class IntrusiveLru {
+public:
+    explicit IntrusiveLru(size_t capacity) : capacity_(capacity) {
+        index_.Reserve(capacity);
+    }
+
+    uint64_t Get(uint64_t key) {
+        if (Entry* entry = index_.Find(key)) {
+            order_.MoveToBack(entry);
+            return entry->value;
+        }
+        if (order_.Size() == capacity_) {
+            index_.Erase(order_.PopFront().Get());
+        }
+        auto entry = MakeIntrusive<Entry>(key);
+        uint64_t value = entry->value;
+        index_.Insert(entry);
+        order_.PushBack(std::move(entry));
+        return value;
+    }
+
+private:
+    size_t capacity_;
+    IntrusiveList<Entry> order_;
+    IntrusiveHashSet<Entry, EntryKey> index_;
+};
+
+class StdLru {
+public:
+    explicit StdLru(size_t capacity) : capacity_(capacity) {
+        index_.reserve(capacity);
+    }
+
+    uint64_t Get(uint64_t key) {
+        if (auto it = index_.find(key); it != index_.end()) {
+            order_.splice(order_.end(), order_, it->second);
+            return (*it->second)->value;
+        }
+        if (order_.size() == capacity_) {
+            index_.erase(order_.front()->key);
+            order_.pop_front();
+        }
+        order_.push_back(MakeIntrusive<Entry>(key));
+        index_.emplace(key, std::prev(order_.end()));
+        return order_.back()->value;
+    }
+
+private:
+    size_t capacity_;
+    std::list<IntrusivePtr<Entry>> order_;
+    std::unordered_map<uint64_t, std::list<IntrusivePtr<Entry>>::iterator> index_;
+};
+
+template <typename Cache>
+double Run(size_t capacity, const std::vector<uint64_t>& keys) {
+    Cache cache(capacity);
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t key : keys) {
+        checksum += cache.Get(key);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    if (checksum == 42) {
+        std::puts("");
+    }
+    return elapsed.count() / keys.size();
+}
+
+int main() {
+    constexpr size_t kOperations = 10'000'000;
+
+    std::printf("%-12s %14s %14s\n", "capacity", "intrusive ns", "std ns");
+    for (size_t capacity : {1'000, 100'000, 1'000'000}) {
+        // Skewed key popularity: most requests hit a working set around `capacity`
+        std::mt19937_64 rng(capacity);
+        std::exponential_distribution<double> popularity(1.0 / capacity);
+        std::vector<uint64_t> keys(kOperations);
+        for (auto& key : keys) {
+            key = static_cast<uint64_t>(popularity(rng));
+        }
+
+        double intrusive = Run<IntrusiveLru>(capacity, keys);
+        double standard = Run<StdLru>(capacity, keys);
+        std::printf("%-12zu %14.1f %14.1f\n", capacity, intrusive, standard);
+    }
+    return 0;
+}
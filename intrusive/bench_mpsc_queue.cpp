@@ -0,0 +1,113 @@
+#include "mpsc_queue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// MpscQueue vs std::mutex + std::deque: throughput and push-to-pop latency
+
+using Clock = std::chrono::steady_clock;
+
+struct Message : AtomicRefCounted<Message>, MpscQueueHook {
+    Clock::time_point pushed_at;
+};
+
+class MutexQueue {
+public:
+    void Push(IntrusivePtr<Message> item) {
+        std::lock_guard guard(mutex_);
+        items_.push_back(std::move(item));
+    }
+
+    IntrusivePtr<Message> TryPop() {
+        std::lock_guard guard(mutex_);
+        if (items_.empty()) {
+            return nullptr;
+        }
+        auto item = std::move(items_.front());
+        items_.pop_front();
+        return item;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<IntrusivePtr<Message>> items_;
+};
+
+struct Result {
+    double mops;
+    double p50_ns;
+    double p99_ns;
+};
+
+template <typename Queue>
+Result Run(int producers_count, int per_producer) {
+    constexpr int kSampleEvery = 64;
+
+    // Preallocate so both queues are measured without the allocator in the loop
+    std::vector<std::vector<IntrusivePtr<Message>>> messages(producers_count);
+    for (auto& batch : messages) {
+        for (int i = 0; i < per_producer; ++i) {
+            batch.push_back(MakeIntrusive<Message>());
+        }
+    }
+
+    Queue queue;
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<size_t>(producers_count) * per_producer / kSampleEvery + 1);
+
+    auto start = Clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producers_count; ++p) {
+        producers.emplace_back([&queue, &batch = messages[p]] {
+            for (auto& message : batch) {
+                message->pushed_at = Clock::now();
+                queue.Push(std::move(message));
+            }
+        });
+    }
+
+    int64_t total = static_cast<int64_t>(producers_count) * per_producer;
+    for (int64_t received = 0; received < total;) {
+        auto message = queue.TryPop();
+        if (!message) {
+            continue;
+        }
+        if (received % kSampleEvery == 0) {
+            latencies.push_back(
+                std::chrono::duration<double, std::nano>(Clock::now() - message->pushed_at)
+                    .count());
+        }
+        ++received;
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    return {total / elapsed / 1e6, latencies[latencies.size() / 2],
+            latencies[latencies.size() * 99 / 100]};
+}
+
+int main() {
+    constexpr int kPerProducer = 1 << 19;
+    unsigned max_producers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+    std::printf("%-10s %-10s %12s %12s %12s\n", "queue", "producers", "Mops/s", "p50 ns",
+                "p99 ns");
+    for (unsigned producers = 1; producers <= max_producers; producers *= 2) {
+        auto lock_free = Run<MpscQueue<Message>>(producers, kPerProducer);
+        auto locked = Run<MutexQueue>(producers, kPerProducer);
+        std::printf("%-10s %-10u %12.2f %12.0f %12.0f\n", "mpsc", producers, lock_free.mops,
+                    lock_free.p50_ns, lock_free.p99_ns);
+        std::printf("%-10s %-10u %12.2f %12.0f %12.0f\n", "mutex", producers, locked.mops,
+                    locked.p50_ns, locked.p99_ns);
+    }
+    return 0;
+}
@@ -1,5 +1,14 @@
 #pragma once
 
+#include <common/accounting.h>
+#include <common/leaks.h>
+#include <common/lifetime.h>
+#include <common/profiling.h>
+#include <common/relocatable.h>
+#include <common/tracepoints.h>
+#include <common/trivial_abi.h>
+
+#include <atomic>
 #include <cstddef>  // for std::nullptr_t
 #include <utility>  // for std::exchange / std::swap
 
@@ -27,6 +36,39 @@ private:
     size_t count_ = 0;
 };
 
+// Thread-safe counter for objects shared between threads.
+// Copying an object must not copy its references, hence the empty copy.
+class AtomicCounter {
+public:
+    AtomicCounter() = default;
+
+    AtomicCounter(const AtomicCounter&) {
+    }
+
+    size_t IncRef() {
+        return count_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    size_t IncRef(size_t count) {
+        return count_.fetch_add(count, std::memory_order_relaxed) + count;
+    }
+
+    size_t DecRef() {
+        return count_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    }
+
+    size_t RefCount() const {
+        return count_.load(std::memory_order_acquire);
+    }
+
+    AtomicCounter& operator=(const AtomicCounter& other) {
+        return *this;
+    }
+
+private:
+    std::atomic<size_t> count_ = 0;
+};
+
 struct DefaultDelete {
     template <typename T>
     static void Destroy(T* object) {
@@ -39,32 +81,80 @@ class RefCounted {
 public:
     // Increase reference counter.
     void IncRef() {
-        counter_.IncRef();
+        size_t count = counter_.IncRef();
+        profiling::OnRefCountChange<Derived>(this);
+        if (count == 1) {
+            leaks::Track<Derived>(this, &CountsOf);
+        }
+    }
+
+    // Increase reference counter by `count` at once (needs a counter that supports it).
+    void IncRef(size_t count) {
+        if (counter_.IncRef(count) == count) {
+            leaks::Track<Derived>(this, &CountsOf);
+        }
+        profiling::OnRefCountChange<Derived>(this);
     }
 
     // Decrease reference counter.
     // Destroy object using Deleter when the last instance dies.
     void DecRef() {
-        counter_.DecRef();
-        if (counter_.RefCount() == 0) {
+        profiling::OnRefCountChange<Derived>(this);
+        size_t count = counter_.DecRef();
+        SMART_POINTERS_TRACE(intrusive_release, this, count, tracepoints::TypeNameOf<Derived>());
+        if (count == 0) {
+            leaks::Untrack(this);
             Deleter::Destroy(static_cast<Derived*>(this));
         }
     }
 
+    // Decrease reference counter but leave destruction to the caller:
+    // returns true if that was the last reference and `Destroy()` is due.
+    bool DecRefNoDestroy() {
+        profiling::OnRefCountChange<Derived>(this);
+        size_t count = counter_.DecRef();
+        SMART_POINTERS_TRACE(intrusive_release, this, count, tracepoints::TypeNameOf<Derived>());
+        if (count == 0) {
+            leaks::Untrack(this);
+        }
+        return count == 0;
+    }
+
+    // Destroy object using Deleter. Only for objects without references left.
+    void Destroy() {
+        Deleter::Destroy(static_cast<Derived*>(this));
+    }
+
     // Get current counter value (the number of strong references).
     size_t RefCount() const {
         return counter_.RefCount();
     }
 
 private:
+    // For the leak registry: tracked from the first reference to the last
+    static leaks::Counts CountsOf(const void* object) {
+        return {static_cast<const RefCounted*>(object)->RefCount(), 0};
+    }
+
     Counter counter_;
+    [[no_unique_address]] accounting::ObjectTracker<Derived, sizeof(Counter)> tracker_;
+    [[no_unique_address]] lifetime::LifetimeTracker<Derived> lifetime_;
 };
 
 template <typename Derived, typename D = DefaultDelete>
 using SimpleRefCounted = RefCounted<Derived, SimpleCounter, D>;
 
+template <typename Derived, typename D = DefaultDelete>
+using AtomicRefCounted = RefCounted<Derived, AtomicCounter, D>;
+
+// Tag for taking over a reference that somebody has already retained
+// (e.g. an object coming from `Detach()` or from a C API).
+struct AdoptRefTag {};
+
+inline constexpr AdoptRefTag kAdoptRef{};
+
 template <typename T>
-class IntrusivePtr {
+class TRIVIAL_ABI IntrusivePtr {
     template <typename Y>
     friend class IntrusivePtr;
 
@@ -82,6 +172,10 @@ public:
         }
     }
 
+    // Takes ownership of an already counted reference, no `IncRef` here
+    IntrusivePtr(T* ptr, AdoptRefTag) noexcept : pointer_(ptr) {
+    }
+
     template <typename Y>
     IntrusivePtr(const IntrusivePtr<Y>& other) {
         pointer_ = other.pointer_;
@@ -91,7 +185,7 @@ public:
     }
 
     template <typename Y>
-    IntrusivePtr(IntrusivePtr<Y>&& other) {
+    IntrusivePtr(IntrusivePtr<Y>&& other) noexcept {
         pointer_ = other.pointer_;
         other.pointer_ = nullptr;
     }
@@ -103,7 +197,7 @@ public:
         }
     }
 
-    IntrusivePtr(IntrusivePtr&& other) {
+    IntrusivePtr(IntrusivePtr&& other) noexcept {
         pointer_ = other.pointer_;
         other.pointer_ = nullptr;
     }
@@ -123,7 +217,7 @@ public:
         return *this;
     }
 
-    IntrusivePtr& operator=(IntrusivePtr&& other) {
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
         if (this == &other) {
             return *this;
         }
@@ -160,7 +254,13 @@ public:
         }
     }
 
-    void Swap(IntrusivePtr& other) {
+    // Releases ownership without `DecRef`: the caller becomes responsible
+    // for the reference, e.g. by passing it back to `AdoptRef`
+    T* Detach() noexcept {
+        return std::exchange(pointer_, nullptr);
+    }
+
+    void Swap(IntrusivePtr& other) noexcept {
         std::swap(pointer_, other.pointer_);
     }
 
@@ -195,6 +295,14 @@ private:
     T* pointer_;
 };
 
+template <typename T>
+struct IsTriviallyRelocatable<IntrusivePtr<T>> : std::true_type {};
+
+template <typename T>
+IntrusivePtr<T> AdoptRef(T* ptr) noexcept {
+    return IntrusivePtr<T>(ptr, kAdoptRef);
+}
+
 template <typename T, typename... Args>
 IntrusivePtr<T> MakeIntrusive(Args&&... args) {
     return IntrusivePtr(new T(std::forward<Args>(args)...));
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Chain link for `IntrusiveHashSet`. Mix it into a `RefCounted` class next to
+// other hooks; use distinct tags for several sets.
+template <typename Tag = void>
+class HashSetHook {
+public:
+    template <typename T, typename KeyOf, typename Hash, typename S>
+    friend class IntrusiveHashSet;
+
+    HashSetHook() = default;
+
+    // Links belong to the set, not to the value, so copies start unlinked
+    HashSetHook(const HashSetHook&) {
+    }
+
+    HashSetHook& operator=(const HashSetHook&) {
+        return *this;
+    }
+
+    bool IsLinked() const {
+        return is_linked_;
+    }
+
+private:
+    HashSetHook* next_ = nullptr;
+    size_t hash_ = 0;
+    bool is_linked_ = false;
+};
+
+// Chained hash set that holds one reference per element. `KeyOf` extracts
+// the key from an element. Insertion and removal never allocate, except for
+// growing the bucket array (use `Reserve` to do it up front).
+template <typename T, typename KeyOf,
+          typename Hash = std::hash<std::decay_t<std::invoke_result_t<KeyOf, const T&>>>,
+          typename Tag = void>
+class IntrusiveHashSet {
+    using Hook = HashSetHook<Tag>;
+    using Key = std::decay_t<std::invoke_result_t<KeyOf, const T&>>;
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from HashSetHook<Tag>");
+
+public:
+    IntrusiveHashSet() = default;
+
+    IntrusiveHashSet(const IntrusiveHashSet&) = delete;
+    IntrusiveHashSet& operator=(const IntrusiveHashSet&) = delete;
+
+    ~IntrusiveHashSet() {
+        Clear();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    // Returns false (and drops `item`) if an element with the same key is
+    // present. `item` must not be null, nor linked into another set with the
+    // same tag.
+    bool Insert(IntrusivePtr<T> item) {
+        assert(item);
+        const Key& key = KeyOf{}(*item);
+        size_t hash = Hash{}(key);
+        if (!buckets_.empty() && FindInBucket(key, hash)) {
+            return false;
+        }
+        if (size_ + 1 > buckets_.size()) {
+            Rehash(buckets_.empty() ? kMinBuckets : buckets_.size() * 2);
+        }
+        Hook* hook = ToHook(item.Detach());
+        assert(!hook->is_linked_);
+        hook->hash_ = hash;
+        hook->is_linked_ = true;
+        Hook*& bucket = buckets_[hash & (buckets_.size() - 1)];
+        hook->next_ = bucket;
+        bucket = hook;
+        ++size_;
+        return true;
+    }
+
+    IntrusivePtr<T> Erase(const Key& key) {
+        if (buckets_.empty()) {
+            return nullptr;
+        }
+        T* item = FindInBucket(key, Hash{}(key));
+        if (!item) {
+            return nullptr;
+        }
+        return Erase(item);
+    }
+
+    // `item` must be linked into this set
+    IntrusivePtr<T> Erase(T* item) {
+        Hook* hook = ToHook(item);
+        Hook** link = &buckets_[hook->hash_ & (buckets_.size() - 1)];
+        while (*link != hook) {
+            link = &(*link)->next_;
+        }
+        *link = hook->next_;
+        hook->next_ = nullptr;
+        hook->is_linked_ = false;
+        --size_;
+        return AdoptRef(item);
+    }
+
+    void Clear() {
+        for (Hook*& bucket : buckets_) {
+            while (bucket) {
+                Hook* hook = bucket;
+                bucket = hook->next_;
+                hook->next_ = nullptr;
+                hook->is_linked_ = false;
+                AdoptRef(ToItem(hook));
+            }
+        }
+        size_ = 0;
+    }
+
+    void Reserve(size_t count) {
+        size_t buckets = kMinBuckets;
+        while (buckets < count) {
+            buckets *= 2;
+        }
+        if (buckets > buckets_.size()) {
+            Rehash(buckets);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    T* Find(const Key& key) const {
+        if (buckets_.empty()) {
+            return nullptr;
+        }
+        return FindInBucket(key, Hash{}(key));
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    static bool IsLinked(const T* item) {
+        return static_cast<const Hook*>(item)->IsLinked();
+    }
+
+private:
+    static constexpr size_t kMinBuckets = 16;
+
+    static Hook* ToHook(T* item) {
+        return static_cast<Hook*>(item);
+    }
+
+    static T* ToItem(Hook* hook) {
+        return static_cast<T*>(hook);
+    }
+
+    T* FindInBucket(const Key& key, size_t hash) const {
+        for (Hook* hook = buckets_[hash & (buckets_.size() - 1)]; hook; hook = hook->next_) {
+            if (hook->hash_ == hash && KeyOf{}(*ToItem(hook)) == key) {
+                return ToItem(hook);
+            }
+        }
+        return nullptr;
+    }
+
+    // Bucket count is a power of two
+    void Rehash(size_t bucket_count) {
+        std::vector<Hook*> buckets(bucket_count, nullptr);
+        for (Hook* bucket : buckets_) {
+            while (bucket) {
+                Hook* next = bucket->next_;
+                Hook*& target = buckets[bucket->hash_ & (bucket_count - 1)];
+                bucket->next_ = target;
+                target = bucket;
+                bucket = next;
+            }
+        }
+        buckets_ = std::move(buckets);
+    }
+
+    std::vector<Hook*> buckets_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Links for `IntrusiveList`. Mix it into a `RefCounted` class; use distinct
+// tags to put the same object into several lists at once:
+//
+//   struct Entry : SimpleRefCounted<Entry>, ListHook<LruTag>, ListHook<DirtyTag> { ... };
+template <typename Tag = void>
+class ListHook {
+public:
+    template <typename T, typename S>
+    friend class IntrusiveList;
+
+    ListHook() = default;
+
+    // Links belong to the list, not to the value, so copies start unlinked
+    ListHook(const ListHook&) {
+    }
+
+    ListHook& operator=(const ListHook&) {
+        return *this;
+    }
+
+    bool IsLinked() const {
+        return next_ != nullptr;
+    }
+
+private:
+    ListHook* prev_ = nullptr;
+    ListHook* next_ = nullptr;
+};
+
+// Doubly-linked list that holds one reference per element. Insertion and
+// removal are O(1) and never allocate.
+template <typename T, typename Tag = void>
+class IntrusiveList {
+    using Hook = ListHook<Tag>;
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from ListHook<Tag>");
+
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        Iterator() = default;
+
+        explicit Iterator(Hook* hook) : hook_(hook) {
+        }
+
+        T& operator*() const {
+            return *ToItem(hook_);
+        }
+
+        T* operator->() const {
+            return ToItem(hook_);
+        }
+
+        Iterator& operator++() {
+            hook_ = hook_->next_;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        Iterator& operator--() {
+            hook_ = hook_->prev_;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return hook_ == other.hook_;
+        }
+
+    private:
+        Hook* hook_ = nullptr;
+    };
+
+    IntrusiveList() {
+        sentinel_.prev_ = &sentinel_;
+        sentinel_.next_ = &sentinel_;
+    }
+
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    ~IntrusiveList() {
+        Clear();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    // For both pushes `item` must not be null, nor linked into a list with the
+    // same tag
+    void PushBack(IntrusivePtr<T> item) {
+        LinkBefore(&sentinel_, ToHook(item.Detach()));
+    }
+
+    void PushFront(IntrusivePtr<T> item) {
+        LinkBefore(sentinel_.next_, ToHook(item.Detach()));
+    }
+
+    IntrusivePtr<T> PopFront() {
+        if (Empty()) {
+            return nullptr;
+        }
+        return Erase(ToItem(sentinel_.next_));
+    }
+
+    IntrusivePtr<T> PopBack() {
+        if (Empty()) {
+            return nullptr;
+        }
+        return Erase(ToItem(sentinel_.prev_));
+    }
+
+    // `item` must be linked into this list
+    IntrusivePtr<T> Erase(T* item) {
+        Hook* hook = ToHook(item);
+        Unlink(hook);
+        return AdoptRef(item);
+    }
+
+    // Relinking keeps the reference, so these cost no count updates
+    void MoveToBack(T* item) {
+        Hook* hook = ToHook(item);
+        Unlink(hook);
+        LinkBefore(&sentinel_, hook);
+    }
+
+    void MoveToFront(T* item) {
+        Hook* hook = ToHook(item);
+        Unlink(hook);
+        LinkBefore(sentinel_.next_, hook);
+    }
+
+    void Clear() {
+        while (PopFront()) {
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    T* Front() const {
+        return Empty() ? nullptr : ToItem(sentinel_.next_);
+    }
+
+    T* Back() const {
+        return Empty() ? nullptr : ToItem(sentinel_.prev_);
+    }
+
+    static bool IsLinked(const T* item) {
+        return static_cast<const Hook*>(item)->IsLinked();
+    }
+
+    Iterator begin() {
+        return Iterator(sentinel_.next_);
+    }
+
+    Iterator end() {
+        return Iterator(&sentinel_);
+    }
+
+private:
+    static Hook* ToHook(T* item) {
+        return static_cast<Hook*>(item);
+    }
+
+    static T* ToItem(Hook* hook) {
+        return static_cast<T*>(hook);
+    }
+
+    void LinkBefore(Hook* position, Hook* hook) {
+        assert(hook && !hook->next_);
+        hook->prev_ = position->prev_;
+        hook->next_ = position;
+        position->prev_->next_ = hook;
+        position->prev_ = hook;
+        ++size_;
+    }
+
+    void Unlink(Hook* hook) {
+        hook->prev_->next_ = hook->next_;
+        hook->next_->prev_ = hook->prev_;
+        hook->prev_ = nullptr;
+        hook->next_ = nullptr;
+        --size_;
+    }
+
+    Hook sentinel_;
+    size_t size_ = 0;
+};
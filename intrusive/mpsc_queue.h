@@ -0,0 +1,108 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <atomic>
+#include <cassert>
+#include <type_traits>
+
+// Link field for `MpscQueue`. Mix it into a `RefCounted` class:
+//
+//   struct Message : AtomicRefCounted<Message>, MpscQueueHook { ... };
+//
+// An object can be in at most one queue at a time.
+class MpscQueueHook {
+public:
+    template <typename T>
+    friend class MpscQueue;
+
+    MpscQueueHook() = default;
+
+    // Links belong to the queue, not to the value, so copies start unlinked
+    MpscQueueHook(const MpscQueueHook&) {
+    }
+
+    MpscQueueHook& operator=(const MpscQueueHook&) {
+        return *this;
+    }
+
+private:
+    std::atomic<MpscQueueHook*> next_ = nullptr;
+};
+
+// Lock-free multi-producer single-consumer queue (Vyukov's intrusive design).
+// The queue owns one reference per element: `Push` detaches it from the
+// pointer and `TryPop` adopts it back, so no `IncRef`/`DecRef` and no
+// allocations happen inside the queue.
+template <typename T>
+class MpscQueue {
+    static_assert(std::is_base_of_v<MpscQueueHook, T>, "T must derive from MpscQueueHook");
+
+public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+        while (TryPop()) {
+        }
+    }
+
+    // Any thread. `item` must not be null: an empty pointer has no hook to
+    // link.
+    void Push(IntrusivePtr<T> item) {
+        assert(item);
+        PushHook(static_cast<MpscQueueHook*>(item.Detach()));
+    }
+
+    // Consumer thread only. Returns an empty pointer if the queue is empty
+    // or a producer is still in the middle of linking its element.
+    IntrusivePtr<T> TryPop() {
+        MpscQueueHook* tail = tail_;
+        MpscQueueHook* next = tail->next_.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (!next) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next_.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return Adopt(tail);
+        }
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        PushHook(&stub_);
+        next = tail->next_.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return Adopt(tail);
+        }
+        return nullptr;
+    }
+
+    // Consumer thread only
+    bool Empty() const {
+        return tail_ == &stub_ && !stub_.next_.load(std::memory_order_acquire);
+    }
+
+private:
+    void PushHook(MpscQueueHook* hook) {
+        hook->next_.store(nullptr, std::memory_order_relaxed);
+        MpscQueueHook* prev = head_.exchange(hook, std::memory_order_acq_rel);
+        prev->next_.store(hook, std::memory_order_release);
+    }
+
+    static IntrusivePtr<T> Adopt(MpscQueueHook* hook) {
+        return AdoptRef(static_cast<T*>(hook));
+    }
+
+    MpscQueueHook stub_;
+    alignas(64) std::atomic<MpscQueueHook*> head_;
+    alignas(64) MpscQueueHook* tail_;
+};
@@ -1,5 +1,7 @@
 #include "intrusive.h"
 
+#include <common/relocating_vector.h>
+
 #include <catch.hpp>
 
 #include "allocations_checker.h"
@@ -239,6 +241,66 @@ TEST_CASE("From raw pointer") {
     REQUIRE(str->RefCount() == 4);
 }
 
+TEST_CASE("Adopt/detach") {
+    SECTION("Detach keeps reference") {
+        IntrusivePtr<MyString> a = MakeIntrusive<MyString>("detached");
+        MyString* raw = a.Detach();
+        REQUIRE(!a);
+        REQUIRE(raw->RefCount() == 1);
+
+        IntrusivePtr<MyString> b = AdoptRef(raw);
+        REQUIRE(b.UseCount() == 1);
+        REQUIRE(*b == "detached");
+    }
+
+    SECTION("Adopt does not increment") {
+        MyString* str = new MyString{"retained"};
+        str->IncRef();
+        IntrusivePtr<MyString> a{str, kAdoptRef};
+        REQUIRE(a.UseCount() == 1);
+        IntrusivePtr<MyString> b = a;
+        REQUIRE(str->RefCount() == 2);
+    }
+
+    SECTION("Handoff without count traffic") {
+        CountedString::ResetCounters();
+        std::vector<CountedString*> queue;
+        {
+            auto p = MakeIntrusive<CountedString>("message");
+            queue.push_back(p.Detach());
+        }
+        REQUIRE(CountedString::NumAlive() == 1);
+        REQUIRE(queue.back()->RefCount() == 1);
+        {
+            auto p = AdoptRef(queue.back());
+            queue.pop_back();
+            REQUIRE(*p == "message");
+        }
+        REQUIRE(CountedString::NumAlive() == 0);
+    }
+
+    SECTION("Noexcept moves") {
+        static_assert(std::is_nothrow_move_constructible_v<IntrusivePtr<MyString>>);
+        static_assert(std::is_nothrow_move_assignable_v<IntrusivePtr<MyString>>);
+    }
+}
+
+TEST_CASE("Trivial relocation") {
+    static_assert(kIsTriviallyRelocatable<IntrusivePtr<MyString>>);
+
+    RelocatingVector<IntrusivePtr<MyString>> v;
+    auto str = MakeIntrusive<MyString>("shared");
+    for (int i = 0; i < 1000; ++i) {
+        v.PushBack(IntrusivePtr(str));
+    }
+    REQUIRE(str.UseCount() == 1001);
+    for (auto& ptr : v) {
+        REQUIRE(ptr.Get() == str.Get());
+    }
+    v.Clear();
+    REQUIRE(str.UseCount() == 1);
+}
+
 struct Pinned : SimpleRefCounted<Pinned> {
     Pinned(int tag) : tag_(tag) {
     }
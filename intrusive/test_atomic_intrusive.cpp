@@ -0,0 +1,107 @@
+#include "atomic_intrusive.h"
+
+#include <catch.hpp>
+
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Version : AtomicRefCounted<Version> {
+    Version(int value) : value{value} {
+        ++alive;
+    }
+
+    ~Version() {
+        --alive;
+    }
+
+    int value;
+
+    static inline std::atomic<int> alive = 0;
+};
+
+TEST_CASE("AtomicIntrusivePtr single thread") {
+    SECTION("Load/store") {
+        AtomicIntrusivePtr<Version> slot;
+        REQUIRE(slot.IsLockFree());
+        REQUIRE(!slot.Load());
+
+        auto first = MakeIntrusive<Version>(1);
+        slot.Store(first);
+        REQUIRE(first.UseCount() == 2);
+        {
+            auto loaded = slot.Load();
+            REQUIRE(loaded.Get() == first.Get());
+            REQUIRE(first.UseCount() == 3);
+        }
+        REQUIRE(first.UseCount() == 2);
+
+        auto old = slot.Exchange(MakeIntrusive<Version>(2));
+        REQUIRE(old.Get() == first.Get());
+        REQUIRE(slot.Load()->value == 2);
+        old.Reset();
+        REQUIRE(first.UseCount() == 1);
+
+        slot.Store(nullptr);
+        REQUIRE(!slot.Load());
+        REQUIRE(Version::alive == 1);
+    }
+
+    SECTION("Compare exchange") {
+        auto first = MakeIntrusive<Version>(1);
+        AtomicIntrusivePtr<Version> slot(first);
+
+        IntrusivePtr<Version> expected;
+        REQUIRE(!slot.CompareExchange(expected, MakeIntrusive<Version>(2)));
+        REQUIRE(expected.Get() == first.Get());
+
+        REQUIRE(slot.CompareExchange(expected, MakeIntrusive<Version>(3)));
+        REQUIRE(slot.Load()->value == 3);
+        REQUIRE(first.UseCount() == 2);
+        expected.Reset();
+        REQUIRE(first.UseCount() == 1);
+    }
+
+    REQUIRE(Version::alive == 0);
+}
+
+TEST_CASE("AtomicIntrusivePtr readers and writers") {
+    constexpr int kReaders = 4;
+    constexpr int kWriters = 2;
+    constexpr int kIterations = 20000;
+
+    {
+        AtomicIntrusivePtr<Version> slot(MakeIntrusive<Version>(0));
+        std::atomic<bool> failed = false;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < kReaders; ++i) {
+            threads.emplace_back([&] {
+                for (int j = 0; j < kIterations; ++j) {
+                    auto version = slot.Load();
+                    if (!version || version->RefCount() == 0 || version->value < 0) {
+                        failed = true;
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < kWriters; ++i) {
+            threads.emplace_back([&, i] {
+                for (int j = 0; j < kIterations; ++j) {
+                    if (j % 2) {
+                        slot.Store(MakeIntrusive<Version>(j));
+                    } else {
+                        auto expected = slot.Load();
+                        slot.CompareExchange(expected, MakeIntrusive<Version>(i));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(!failed);
+        REQUIRE(slot.Load().UseCount() == 2);
+    }
+    REQUIRE(Version::alive == 0);
+}
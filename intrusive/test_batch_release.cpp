@@ -0,0 +1,98 @@
+#include "batch_release.h"
+
+#include <catch.hpp>
+
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Node : AtomicRefCounted<Node> {
+    Node() {
+        ++alive;
+    }
+
+    ~Node() {
+        --alive;
+    }
+
+    static inline std::atomic<int> alive = 0;
+};
+
+struct PlainNode {
+    void IncRef() {
+        ++count;
+    }
+
+    void DecRef() {
+        if (--count == 0) {
+            delete this;
+        }
+    }
+
+    size_t RefCount() const {
+        return count;
+    }
+
+    size_t count = 0;
+};
+
+TEST_CASE("ReleaseAll") {
+    SECTION("Destroys only dead objects") {
+        auto survivor = MakeIntrusive<Node>();
+        std::vector<IntrusivePtr<Node>> ptrs;
+        for (int i = 0; i < 100; ++i) {
+            ptrs.push_back(MakeIntrusive<Node>());
+            ptrs.push_back(survivor);
+            ptrs.push_back(nullptr);
+        }
+        REQUIRE(Node::alive == 101);
+        REQUIRE(survivor.UseCount() == 101);
+
+        auto dead = DecRefAll(std::span<IntrusivePtr<Node>>(ptrs));
+        REQUIRE(dead.size() == 100);
+        REQUIRE(Node::alive == 101);
+        REQUIRE(survivor.UseCount() == 1);
+        for (auto& ptr : ptrs) {
+            REQUIRE(!ptr);
+        }
+
+        DestroyAll(dead);
+        REQUIRE(Node::alive == 1);
+    }
+
+    SECTION("Vector overload") {
+        std::vector<IntrusivePtr<Node>> ptrs(10);
+        for (auto& ptr : ptrs) {
+            ptr = MakeIntrusive<Node>();
+        }
+        ReleaseAll(ptrs);
+        REQUIRE(ptrs.empty());
+        REQUIRE(Node::alive == 0);
+    }
+
+    SECTION("Custom counter falls back to DecRef") {
+        std::vector<IntrusivePtr<PlainNode>> ptrs;
+        for (int i = 0; i < 10; ++i) {
+            ptrs.push_back(MakeIntrusive<PlainNode>());
+        }
+        REQUIRE(DecRefAll(std::span<IntrusivePtr<PlainNode>>(ptrs)).empty());
+    }
+
+    REQUIRE(Node::alive == 0);
+}
+
+TEST_CASE("BackgroundReleaser") {
+    BackgroundReleaser releaser;
+    auto survivor = MakeIntrusive<Node>();
+    for (int round = 0; round < 10; ++round) {
+        std::vector<IntrusivePtr<Node>> ptrs;
+        for (int i = 0; i < 1000; ++i) {
+            ptrs.push_back(i % 10 ? MakeIntrusive<Node>() : survivor);
+        }
+        releaser.ReleaseAll(ptrs);
+        REQUIRE(ptrs.empty());
+    }
+    releaser.Flush();
+    REQUIRE(Node::alive == 1);
+    REQUIRE(survivor.UseCount() == 1);
+}
@@ -0,0 +1,191 @@
+#include "intrusive_hash_set.h"
+#include "intrusive_list.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct LruTag;
+struct DirtyTag;
+
+struct Entry : SimpleRefCounted<Entry>, ListHook<LruTag>, ListHook<DirtyTag>, HashSetHook<> {
+    Entry(int key, std::string value) : key{key}, value{std::move(value)} {
+        ++alive;
+    }
+
+    ~Entry() {
+        --alive;
+    }
+
+    int key;
+    std::string value;
+
+    static inline int alive = 0;
+};
+
+struct EntryKey {
+    int operator()(const Entry& entry) const {
+        return entry.key;
+    }
+};
+
+using LruList = IntrusiveList<Entry, LruTag>;
+using DirtyList = IntrusiveList<Entry, DirtyTag>;
+using EntrySet = IntrusiveHashSet<Entry, EntryKey>;
+
+template <typename List>
+std::vector<int> Keys(List& list) {
+    std::vector<int> keys;
+    for (auto& entry : list) {
+        keys.push_back(entry.key);
+    }
+    return keys;
+}
+
+TEST_CASE("IntrusiveList") {
+    SECTION("Push/pop") {
+        LruList list;
+        REQUIRE(list.Empty());
+        REQUIRE(!list.PopFront());
+
+        list.PushBack(MakeIntrusive<Entry>(2, "b"));
+        list.PushBack(MakeIntrusive<Entry>(3, "c"));
+        list.PushFront(MakeIntrusive<Entry>(1, "a"));
+        REQUIRE(list.Size() == 3);
+        REQUIRE(Keys(list) == std::vector<int>{1, 2, 3});
+        REQUIRE(list.Front()->key == 1);
+        REQUIRE(list.Back()->key == 3);
+
+        auto back = list.PopBack();
+        REQUIRE(back->key == 3);
+        REQUIRE(back.UseCount() == 1);
+        REQUIRE(!LruList::IsLinked(back.Get()));
+        REQUIRE(Keys(list) == std::vector<int>{1, 2});
+    }
+
+    SECTION("Membership holds a reference") {
+        auto entry = MakeIntrusive<Entry>(1, "a");
+        {
+            LruList list;
+            list.PushBack(entry);
+            REQUIRE(entry.UseCount() == 2);
+            REQUIRE(LruList::IsLinked(entry.Get()));
+        }
+        REQUIRE(entry.UseCount() == 1);
+        REQUIRE(!LruList::IsLinked(entry.Get()));
+
+        Entry* raw;
+        {
+            LruList list;
+            list.PushBack(std::move(entry));
+            raw = list.Front();
+            REQUIRE(raw->RefCount() == 1);
+        }
+        REQUIRE(Entry::alive == 0);
+    }
+
+    SECTION("Erase and move") {
+        LruList list;
+        for (int i = 0; i < 5; ++i) {
+            list.PushBack(MakeIntrusive<Entry>(i, ""));
+        }
+        Entry* middle = &*std::next(list.begin(), 2);
+        list.MoveToBack(middle);
+        REQUIRE(Keys(list) == std::vector<int>{0, 1, 3, 4, 2});
+        list.MoveToFront(middle);
+        REQUIRE(Keys(list) == std::vector<int>{2, 0, 1, 3, 4});
+        REQUIRE(middle->RefCount() == 1);
+
+        auto erased = list.Erase(list.Back());
+        REQUIRE(erased->key == 4);
+        REQUIRE(Keys(list) == std::vector<int>{2, 0, 1, 3});
+        REQUIRE(list.Size() == 4);
+    }
+
+    SECTION("Several lists at once") {
+        LruList lru;
+        DirtyList dirty;
+        auto entry = MakeIntrusive<Entry>(7, "x");
+        lru.PushBack(entry);
+        dirty.PushBack(entry);
+        REQUIRE(entry.UseCount() == 3);
+        dirty.Erase(entry.Get());
+        REQUIRE(LruList::IsLinked(entry.Get()));
+        REQUIRE(!DirtyList::IsLinked(entry.Get()));
+        REQUIRE(entry.UseCount() == 2);
+    }
+
+    SECTION("No allocations") {
+        LruList list;
+        auto a = MakeIntrusive<Entry>(1, "");
+        auto b = MakeIntrusive<Entry>(2, "");
+        EXPECT_ZERO_ALLOCATIONS(list.PushBack(a); list.PushFront(b); list.MoveToBack(b.Get());
+                                list.Erase(a.Get()); list.PopFront(););
+    }
+}
+
+TEST_CASE("IntrusiveHashSet") {
+    SECTION("Insert/find/erase") {
+        EntrySet set;
+        REQUIRE(!set.Find(1));
+        REQUIRE(!set.Erase(1));
+
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE(set.Insert(MakeIntrusive<Entry>(i, std::to_string(i))));
+        }
+        REQUIRE(set.Size() == 1000);
+        REQUIRE(!set.Insert(MakeIntrusive<Entry>(10, "duplicate")));
+        REQUIRE(set.Find(10)->value == "10");
+
+        for (int i = 0; i < 1000; i += 2) {
+            auto erased = set.Erase(i);
+            REQUIRE(erased->key == i);
+            REQUIRE(erased.UseCount() == 1);
+        }
+        REQUIRE(set.Size() == 500);
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE((set.Find(i) != nullptr) == (i % 2 == 1));
+        }
+    }
+
+    SECTION("Erase by element") {
+        EntrySet set;
+        auto entry = MakeIntrusive<Entry>(5, "five");
+        set.Insert(entry);
+        REQUIRE(EntrySet::IsLinked(entry.Get()));
+        REQUIRE(entry.UseCount() == 2);
+        set.Erase(entry.Get());
+        REQUIRE(!EntrySet::IsLinked(entry.Get()));
+        REQUIRE(entry.UseCount() == 1);
+    }
+
+    SECTION("Clear releases elements") {
+        {
+            EntrySet set;
+            for (int i = 0; i < 100; ++i) {
+                set.Insert(MakeIntrusive<Entry>(i, ""));
+            }
+            set.Clear();
+            REQUIRE(set.Empty());
+            REQUIRE(Entry::alive == 0);
+            set.Insert(MakeIntrusive<Entry>(1, ""));
+        }
+        REQUIRE(Entry::alive == 0);
+    }
+
+    SECTION("No allocations after Reserve") {
+        EntrySet set;
+        set.Reserve(64);
+        std::vector<IntrusivePtr<Entry>> entries;
+        for (int i = 0; i < 64; ++i) {
+            entries.push_back(MakeIntrusive<Entry>(i, ""));
+        }
+        EXPECT_ZERO_ALLOCATIONS(for (auto& entry : entries) { set.Insert(entry); } set.Erase(3);
+                                set.Erase(entries[5].Get()););
+    }
+}
@@ -0,0 +1,113 @@
+#include "mpsc_queue.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Message : AtomicRefCounted<Message>, MpscQueueHook {
+    Message(int producer, int seq) : producer{producer}, seq{seq} {
+        ++alive;
+    }
+
+    ~Message() {
+        --alive;
+    }
+
+    int producer;
+    int seq;
+
+    static inline std::atomic<int> alive = 0;
+};
+
+TEST_CASE("MpscQueue single thread") {
+    SECTION("FIFO order") {
+        MpscQueue<Message> queue;
+        REQUIRE(queue.Empty());
+        REQUIRE(!queue.TryPop());
+
+        for (int i = 0; i < 10; ++i) {
+            queue.Push(MakeIntrusive<Message>(0, i));
+        }
+        REQUIRE(!queue.Empty());
+        for (int i = 0; i < 10; ++i) {
+            auto msg = queue.TryPop();
+            REQUIRE(msg);
+            REQUIRE(msg->seq == i);
+        }
+        REQUIRE(!queue.TryPop());
+        REQUIRE(queue.Empty());
+    }
+
+    SECTION("Reference is transferred") {
+        MpscQueue<Message> queue;
+        auto msg = MakeIntrusive<Message>(0, 0);
+        Message* raw = msg.Get();
+        queue.Push(msg);
+        REQUIRE(raw->RefCount() == 2);
+        msg.Reset();
+        REQUIRE(raw->RefCount() == 1);
+
+        auto popped = queue.TryPop();
+        REQUIRE(popped.Get() == raw);
+        REQUIRE(popped.UseCount() == 1);
+    }
+
+    SECTION("No allocations") {
+        MpscQueue<Message> queue;
+        auto a = MakeIntrusive<Message>(0, 0);
+        auto b = MakeIntrusive<Message>(0, 1);
+        EXPECT_ZERO_ALLOCATIONS(queue.Push(std::move(a)); queue.Push(std::move(b));
+                                queue.TryPop(); queue.TryPop(););
+    }
+
+    SECTION("Destructor releases elements") {
+        {
+            MpscQueue<Message> queue;
+            for (int i = 0; i < 5; ++i) {
+                queue.Push(MakeIntrusive<Message>(0, i));
+            }
+        }
+        REQUIRE(Message::alive == 0);
+    }
+}
+
+TEST_CASE("MpscQueue many producers") {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+
+    MpscQueue<Message> queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.Push(MakeIntrusive<Message>(p, i));
+            }
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    bool in_order = true;
+    while (received < kProducers * kPerProducer) {
+        auto msg = queue.TryPop();
+        if (!msg) {
+            std::this_thread::yield();
+            continue;
+        }
+        in_order = in_order && msg->seq == next[msg->producer];
+        next[msg->producer] = msg->seq + 1;
+        ++received;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    REQUIRE(in_order);
+    REQUIRE(!queue.TryPop());
+    REQUIRE(Message::alive == 0);
+}
@@ -2,6 +2,12 @@
 
 #include "sw_fwd.h"  // Forward declaration
 
+#include <common/accounting.h>
+#include <common/leaks.h>
+#include <common/lifetime.h>
+#include <common/profiling.h>
+#include <common/tracepoints.h>
+
 #include <cstddef>  // std::nullptr_t
 
 class EnableSharedFromThisBase {};
@@ -56,20 +62,35 @@ public:
 
     virtual void DestroyObject(bool& flag) = 0;
 
+    // Bytes the block keeps allocated: itself, plus the object while it lives
+    // if that was allocated separately
+    virtual size_t AllocatedSize() = 0;
+
     void TryDestroy() {
         bool block_lifetime_extend = false;
         if (!GetStrongReferenceCount()) {
+            // The object may hold the last weak reference to its own block
+            // (a back pointer), which must not free the block under us
+            IncreaseWeakReferenceCount();
             DestroyObject(block_lifetime_extend);
+            DecreaseWeakReferenceCount();
         }
         if (block_lifetime_extend) {
             DecreaseWeakReferenceCount();
         }
         if (!GetStrongReferenceCount() && !GetWeakReferenceCount()) {
+            SMART_POINTERS_TRACE(block_free, this);
             delete this;
         }
     }
 
     virtual ~BaseBlock(){};
+
+    // For the leak registry, which keeps blocks as `const void*`
+    static leaks::Counts CountsOf(const void* block) {
+        auto* self = static_cast<BaseBlock*>(const_cast<void*>(block));
+        return {self->GetStrongReferenceCount(), self->GetWeakReferenceCount()};
+    }
 };
 
 template <typename T>
@@ -79,12 +100,20 @@ public:
         strong_reference_count_ = 0;
         weak_reference_count_ = 0;
         pointer_ = nullptr;
+        accounting::OverheadAdded<T>(sizeof(SimpleControlBlock));
+        leaks::Track<T>(static_cast<BaseBlock*>(this), &CountsOf, sizeof(SimpleControlBlock));
     }
 
     SimpleControlBlock(T* pointer) {
         strong_reference_count_ = 0;
         weak_reference_count_ = 0;
         pointer_ = pointer;
+        accounting::OverheadAdded<T>(sizeof(SimpleControlBlock));
+        if (pointer_) {
+            accounting::ObjectCreated<T>();
+        }
+        leaks::Track<T>(static_cast<BaseBlock*>(this), &CountsOf,
+                        sizeof(SimpleControlBlock) + (pointer_ ? sizeof(T) : 0));
     }
 
     size_t GetStrongReferenceCount() override {
@@ -93,10 +122,12 @@ public:
 
     void IncreaseStrongReferenceCount() override {
         ++strong_reference_count_;
+        profiling::OnRefCountChange<T>(this);
     }
 
     void DecreaseStrongReferenceCount() override {
         --strong_reference_count_;
+        profiling::OnRefCountChange<T>(this);
     }
 
     size_t GetWeakReferenceCount() override {
@@ -111,6 +142,10 @@ public:
         --weak_reference_count_;
     }
 
+    size_t AllocatedSize() override {
+        return sizeof(SimpleControlBlock) + (pointer_ ? sizeof(T) : 0);
+    }
+
     void DestroyObject(bool& block_lifetime_extend) override {
         if (!is_alive_) {
             return;
@@ -125,14 +160,20 @@ public:
                 is_alive_ = false;
                 delete pointer_;
             }
+            accounting::ObjectDestroyed<T>();
+            lifetime_.Stop();
         }
         pointer_ = nullptr;
     }
 
     ~SimpleControlBlock() override {
+        leaks::Untrack(static_cast<BaseBlock*>(this));
         if (!strong_reference_count_ && !weak_reference_count_ && pointer_) {
             delete pointer_;
+            accounting::ObjectDestroyed<T>();
+            lifetime_.Stop();
         }
+        accounting::OverheadRemoved<T>(sizeof(SimpleControlBlock));
     }
 
 private:
@@ -140,6 +181,7 @@ private:
     size_t strong_reference_count_;
     size_t weak_reference_count_;
     bool is_alive_ = true;
+    [[no_unique_address]] lifetime::Stopwatch<T> lifetime_;
 };
 
 template <typename T>
@@ -153,6 +195,10 @@ public:
         new (&storage_) T(std::forward<Args>(args)...);
         weak_reference_count_ = 0;
         strong_reference_count_ = 0;
+        accounting::ObjectCreated<T>();
+        // Counters and vtable pointer share the allocation with the object
+        accounting::OverheadAdded<T>(sizeof(ComplexControlBlock) - sizeof(T));
+        leaks::Track<T>(static_cast<BaseBlock*>(this), &CountsOf, sizeof(ComplexControlBlock));
     }
 
     size_t GetStrongReferenceCount() {
@@ -161,10 +207,12 @@ public:
 
     void IncreaseStrongReferenceCount() {
         ++strong_reference_count_;
+        profiling::OnRefCountChange<T>(this);
     }
 
     void DecreaseStrongReferenceCount() {
         --strong_reference_count_;
+        profiling::OnRefCountChange<T>(this);
     }
 
     size_t GetWeakReferenceCount() {
@@ -179,6 +227,11 @@ public:
         --weak_reference_count_;
     }
 
+    // The object's storage is part of the block and outlives the object
+    size_t AllocatedSize() override {
+        return sizeof(ComplexControlBlock);
+    }
+
     void DestroyObject(bool& block_lifetime_extend) {
         if (!strong_reference_count_ && is_alive_) {
             if constexpr (std::is_convertible_v<T*, EnableSharedFromThisBase*>) {
@@ -195,13 +248,19 @@ public:
                 is_alive_ = false;
                 reinterpret_cast<T*>(&storage_)->~T();
             }
+            accounting::ObjectDestroyed<T>();
+            lifetime_.Stop();
         }
     }
 
     ~ComplexControlBlock() override {
+        leaks::Untrack(static_cast<BaseBlock*>(this));
         if (is_alive_) {
             reinterpret_cast<T*>(&storage_)->~T();
+            accounting::ObjectDestroyed<T>();
+            lifetime_.Stop();
         }
+        accounting::OverheadRemoved<T>(sizeof(ComplexControlBlock) - sizeof(T));
     }
 
     typename std::aligned_storage_t<sizeof(T), alignof(T)>::type* GetStorage() {
@@ -213,6 +272,7 @@ private:
     size_t weak_reference_count_;
     typename std::aligned_storage_t<sizeof(T), alignof(T)>::type storage_;
     bool is_alive_ = true;
+    [[no_unique_address]] lifetime::Stopwatch<T> lifetime_;
 };
 
 // https://en.cppreference.com/w/cpp/memory/shared_ptr
@@ -376,6 +436,9 @@ public:
         pointer_ = nullptr;
         if (control_block_) {
             control_block_->DecreaseStrongReferenceCount();
+            SMART_POINTERS_TRACE(unsubscribe, control_block_,
+                                 control_block_->GetStrongReferenceCount(),
+                                 tracepoints::TypeNameOf<T>());
             control_block_->TryDestroy();
         }
         control_block_ = nullptr;
@@ -385,6 +448,9 @@ public:
         control_block_ = control_block;
         if (control_block_) {
             control_block_->IncreaseStrongReferenceCount();
+            SMART_POINTERS_TRACE(subscribe, control_block_,
+                                 control_block_->GetStrongReferenceCount(),
+                                 tracepoints::TypeNameOf<T>());
         }
     }
 
@@ -431,17 +497,4 @@ SharedPtr<T> MakeShared(Args&&... args) {
     return output;
 }
 
-<<<<<<< Updated upstream
-// Look for usage examples in tests and seminar
-template <typename T>
-class EnableSharedFromThis {
-public:
-    SharedPtr<T> SharedFromThis();
-    SharedPtr<const T> SharedFromThis() const;
-
-    WeakPtr<T> WeakFromThis() noexcept;
-    WeakPtr<const T> WeakFromThis() const noexcept;
-};
-=======
 // Look for usage examples in tests
->>>>>>> Stashed changes
@@ -162,4 +162,21 @@ TEST_CASE("Lifetimes") {
         }
         delete wp;
     }
+
+    SECTION("Object holds the last weak reference to itself") {
+        struct Node {
+            SharedPtr<Node> next;
+            WeakPtr<Node> prev;
+        };
+
+        for (bool make_shared : {true, false}) {
+            auto first = make_shared ? MakeShared<Node>() : SharedPtr<Node>(new Node);
+            auto second = make_shared ? MakeShared<Node>() : SharedPtr<Node>(new Node);
+            first->next = second;
+            second->prev = first;
+            second.Reset();
+            // Destroying `first` destroys `second`, which drops the last weak
+            // reference to `first` while it is being destroyed
+        }
+    }
 }
@@ -102,6 +102,7 @@ public:
 
     SharedPtr<T> Lock() const {
         if (Expired()) {
+            SMART_POINTERS_TRACE(lock_failed, control_block_, tracepoints::TypeNameOf<T>());
             return SharedPtr<T>();
         }
         SharedPtr<T> output;
@@ -110,7 +111,7 @@ public:
         return output;
     }
 
-    BaseBlock* GetControlBlock() {
+    BaseBlock* GetControlBlock() const {
         return control_block_;
     }
 
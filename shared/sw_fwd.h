@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/relocatable.h>
+
 #include <exception>
 
 class BadWeakPtr : public std::exception {};
@@ -9,3 +11,10 @@ class SharedPtr;
 
 template <typename T>
 class WeakPtr;
+
+// Both hold plain pointers to the object and the control block, nothing points back at them
+template <typename T>
+struct IsTriviallyRelocatable<SharedPtr<T>> : std::true_type {};
+
+template <typename T>
+struct IsTriviallyRelocatable<WeakPtr<T>> : std::true_type {};
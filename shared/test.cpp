@@ -4,6 +4,8 @@
 
 #include "allocations_checker.h"
 
+#include <common/relocating_vector.h>
+
 #include <memory>
 #include <iostream>
 
@@ -472,3 +474,19 @@ TEST_CASE("Destructor for correct type") {
         REQUIRE(B::destructor_called);
     }
 }
+
+TEST_CASE("Trivial relocation") {
+    static_assert(kIsTriviallyRelocatable<SharedPtr<int>>);
+
+    RelocatingVector<SharedPtr<int>> v;
+    auto value = MakeShared<int>(42);
+    for (int i = 0; i < 1000; ++i) {
+        v.PushBack(SharedPtr<int>(value));
+    }
+    REQUIRE(value.UseCount() == 1001);
+    for (auto& ptr : v) {
+        REQUIRE(*ptr == 42);
+    }
+    v.Clear();
+    REQUIRE(value.UseCount() == 1);
+}
@@ -0,0 +1,134 @@
+#include "inline_unique.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Virtual dispatch over 10M small strategy objects: one heap allocation per
+// object (`UniquePtr<Strategy>`) vs objects stored in the handle itself
+// (`InlineUniquePtr<Strategy>`). The heap case is also run after shuffling the
+// handles, which is what the allocations of a long-running program look like.
+
+using Clock = std::chrono::steady_clock;
+
+struct Strategy {
+    virtual ~Strategy() = default;
+    virtual long Apply(long x) const = 0;
+};
+
+struct Add : Strategy {
+    explicit Add(long delta) : delta(delta) {
+    }
+    long Apply(long x) const override {
+        return x + delta;
+    }
+    long delta;
+};
+
+struct Multiply : Strategy {
+    explicit Multiply(long factor) : factor(factor) {
+    }
+    long Apply(long x) const override {
+        return x * factor;
+    }
+    long factor;
+};
+
+struct Clamp : Strategy {
+    Clamp(long low, long high) : low(low), high(high) {
+    }
+    long Apply(long x) const override {
+        return std::clamp(x, low, high);
+    }
+    long low;
+    long high;
+};
+
+constexpr size_t kCount = 10'000'000;
+constexpr int kPasses = 5;
+
+std::vector<int> MakeKinds() {
+    std::mt19937 gen(42);
+    std::vector<int> kinds(kCount);
+    for (auto& kind : kinds) {
+        kind = gen() % 3;
+    }
+    return kinds;
+}
+
+template <typename Ptr, typename Make>
+std::vector<Ptr> Build(const std::vector<int>& kinds, Make make, double* build_ms) {
+    auto start = Clock::now();
+    std::vector<Ptr> objects;
+    objects.reserve(kinds.size());
+    for (size_t i = 0; i < kinds.size(); ++i) {
+        objects.push_back(make(kinds[i], static_cast<long>(i % 7)));
+    }
+    *build_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return objects;
+}
+
+template <typename Ptr>
+double Dispatch(const std::vector<Ptr>& objects) {
+    long value = 0;
+    auto start = Clock::now();
+    for (int pass = 0; pass < kPasses; ++pass) {
+        for (const auto& object : objects) {
+            value = object->Apply(value) & 0xffff;
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    if (value == -1) {
+        std::puts("");
+    }
+    return elapsed / kPasses / objects.size();
+}
+
+template <typename Ptr>
+Ptr MakeStrategy(int kind, long arg) {
+    if constexpr (std::is_same_v<Ptr, UniquePtr<Strategy>>) {
+        switch (kind) {
+            case 0:
+                return MakeUnique<Add>(arg);
+            case 1:
+                return MakeUnique<Multiply>(arg);
+            default:
+                return MakeUnique<Clamp>(0, arg * 1000);
+        }
+    } else {
+        switch (kind) {
+            case 0:
+                return MakeInlineUnique<Strategy, Add>(arg);
+            case 1:
+                return MakeInlineUnique<Strategy, Multiply>(arg);
+            default:
+                return MakeInlineUnique<Strategy, Clamp>(0, arg * 1000);
+        }
+    }
+}
+
+template <typename Ptr>
+void Run(const char* name, const std::vector<int>& kinds, bool shuffle) {
+    double build_ms;
+    auto objects = Build<Ptr>(kinds, MakeStrategy<Ptr>, &build_ms);
+    if (shuffle) {
+        std::shuffle(objects.begin(), objects.end(), std::mt19937(7));
+    }
+    double dispatch_ns = Dispatch(objects);
+    auto start = Clock::now();
+    objects.clear();
+    double destroy_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::printf("%-24s %10.1f %14.2f %12.1f\n", name, build_ms, dispatch_ns, destroy_ms);
+}
+
+int main() {
+    auto kinds = MakeKinds();
+    std::printf("%-24s %10s %14s %12s\n", "", "build ms", "dispatch ns/op", "destroy ms");
+    Run<UniquePtr<Strategy>>("UniquePtr", kinds, false);
+    Run<UniquePtr<Strategy>>("UniquePtr (shuffled)", kinds, true);
+    Run<InlineUniquePtr<Strategy>>("InlineUniquePtr", kinds, false);
+    return 0;
+}
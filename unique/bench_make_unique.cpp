@@ -0,0 +1,43 @@
+#include "unique.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// 64 MiB scratch buffers: MakeUnique (zero-filled) vs MakeUniqueForOverwrite
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Make>
+double Measure(Make make, bool fill) {
+    constexpr size_t kSize = size_t{64} << 20;
+    constexpr int kIterations = 20;
+
+    auto start = Clock::now();
+    size_t checksum = 0;
+    for (int i = 0; i < kIterations; ++i) {
+        auto buffer = make(kSize);
+        if (fill) {
+            std::memset(buffer.Get(), i, kSize);
+        }
+        checksum += static_cast<unsigned char>(buffer[kSize / 2]);
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (checksum == 1) {
+        std::puts("");
+    }
+    return elapsed / kIterations;
+}
+
+int main() {
+    auto zeroed = [](size_t size) { return MakeUnique<char[]>(size); };
+    auto for_overwrite = [](size_t size) { return MakeUniqueForOverwrite<char[]>(size); };
+
+    std::printf("%-26s %14s %22s\n", "", "MakeUnique ms", "MakeUniqueForOverwrite ms");
+    std::printf("%-26s %14.2f %22.2f\n", "allocate + free", Measure(zeroed, false),
+                Measure(for_overwrite, false));
+    std::printf("%-26s %14.2f %22.2f\n", "allocate + fill + free", Measure(zeroed, true),
+                Measure(for_overwrite, true));
+    return 0;
+}
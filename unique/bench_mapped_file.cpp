@@ -0,0 +1,86 @@
+#include "mapped_file.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Loading a large read-only file: read() into a heap buffer vs MappedFile.
+// Usage: bench_mapped_file [size in MiB] [path]
+// The file is written first, so both variants run against a warm page cache.
+
+using Clock = std::chrono::steady_clock;
+
+double Since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+uint64_t Checksum(const uint64_t* data, size_t size) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+void WriteFile(const std::string& path, size_t size) {
+    constexpr size_t kChunk = 1 << 20;
+    auto chunk = MakeUniqueForOverwrite<uint64_t[]>(kChunk / sizeof(uint64_t));
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    for (size_t written = 0; written < size; written += kChunk) {
+        for (size_t i = 0; i < kChunk / sizeof(uint64_t); ++i) {
+            chunk[i] = written + i;
+        }
+        if (write(fd, chunk.Get(), kChunk) != static_cast<ssize_t>(kChunk)) {
+            throw std::system_error(errno, std::generic_category(), "write " + path);
+        }
+    }
+    close(fd);
+}
+
+int main(int argc, char** argv) {
+    size_t mebibytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2048;
+    std::string path = argc > 2 ? argv[2] : "/tmp/bench_mapped_file.bin";
+    size_t size = mebibytes << 20;
+    WriteFile(path, size);
+
+    auto start = Clock::now();
+    auto buffer = MakeUniqueForOverwrite<uint64_t[]>(size / sizeof(uint64_t));
+    int fd = open(path.c_str(), O_RDONLY);
+    for (size_t done = 0; done < size;) {
+        ssize_t got = read(fd, reinterpret_cast<char*>(buffer.Get()) + done, size - done);
+        if (got <= 0) {
+            throw std::system_error(errno, std::generic_category(), "read " + path);
+        }
+        done += got;
+    }
+    close(fd);
+    double buffered_ready = Since(start);
+    uint64_t buffered_sum = Checksum(buffer.Get(), size / sizeof(uint64_t));
+    double buffered_total = Since(start);
+    buffer.Reset();
+
+    start = Clock::now();
+    auto mapped = MappedFile::Open(path, MappedFile::Access::kSequential);
+    double mapped_ready = Since(start);
+    auto view = mapped.View<uint64_t>();
+    uint64_t mapped_sum = Checksum(view.data(), view.size());
+    double mapped_total = Since(start);
+
+    std::remove(path.c_str());
+    if (buffered_sum != mapped_sum) {
+        std::puts("checksum mismatch");
+        return 1;
+    }
+
+    std::printf("%zu MiB file\n", mebibytes);
+    std::printf("%-12s %14s %20s\n", "", "ready ms", "ready + scan ms");
+    std::printf("%-12s %14.1f %20.1f\n", "read()", buffered_ready, buffered_total);
+    std::printf("%-12s %14.1f %20.1f\n", "MappedFile", mapped_ready, mapped_total);
+    return 0;
+}
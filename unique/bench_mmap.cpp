@@ -0,0 +1,63 @@
+#include "mmap.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Random reads from a large table: malloc vs mmap vs mmap + transparent huge pages.
+// Usage: bench_mmap [table size in MiB]
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Table>
+double Measure(Table& table, size_t size) {
+    constexpr size_t kReads = 20'000'000;
+
+    for (size_t i = 0; i < size; ++i) {
+        table[i] = i;
+    }
+
+    uint64_t state = 88172645463325252ull;
+    uint64_t sum = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < kReads; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        sum += table[state % size];
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    if (sum == 1) {
+        std::puts("");
+    }
+    return elapsed / kReads;
+}
+
+int main(int argc, char** argv) {
+    size_t mebibytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    size_t size = (mebibytes << 20) / sizeof(uint64_t);
+
+    double heap = 0;
+    {
+        auto table = MakeUniqueForOverwrite<uint64_t[]>(size);
+        heap = Measure(table, size);
+    }
+    double mapped = 0;
+    {
+        auto table = MakeMmapArray<uint64_t>(size, {.populate = true});
+        mapped = Measure(table, size);
+    }
+    double huge = 0;
+    {
+        auto table = MakeMmapArray<uint64_t>(size, {.huge_pages = true, .populate = true});
+        huge = Measure(table, size);
+    }
+
+    std::printf("%zu MiB table, ns per random read\n", mebibytes);
+    std::printf("%-20s %8.2f\n", "malloc", heap);
+    std::printf("%-20s %8.2f\n", "mmap", mapped);
+    std::printf("%-20s %8.2f\n", "mmap + MADV_HUGEPAGE", huge);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "unique.h"
+
+#include <common/relocating_vector.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Growing a vector of UniquePtr: std::vector (move + destroy per element) vs
+// RelocatingVector (realloc). Usage: bench_relocation [element count]
+
+using Clock = std::chrono::steady_clock;
+
+// Stateless but with a user-provided copy, so it is not trivially relocatable
+struct MovingDeleter {
+    MovingDeleter() = default;
+
+    MovingDeleter(const MovingDeleter&) noexcept {
+    }
+
+    MovingDeleter& operator=(const MovingDeleter&) noexcept {
+        return *this;
+    }
+
+    void operator()(int* pointer) {
+        delete pointer;
+    }
+};
+
+template <typename Vector, typename Push>
+double Measure(size_t count, Push push) {
+    auto start = Clock::now();
+    {
+        Vector v;
+        for (size_t i = 0; i < count; ++i) {
+            push(v);
+        }
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000'000;
+
+    // Elements are empty pointers so that only the growth itself is measured
+    double std_vector = Measure<std::vector<UniquePtr<int>>>(
+        count, [](auto& v) { v.emplace_back(); });
+    double relocating = Measure<RelocatingVector<UniquePtr<int>>>(
+        count, [](auto& v) { v.EmplaceBack(); });
+    double moving = Measure<RelocatingVector<UniquePtr<int, MovingDeleter>>>(
+        count, [](auto& v) { v.EmplaceBack(); });
+
+    std::printf("%zu elements, push back + destroy\n", count);
+    std::printf("%-44s %10.1f ms\n", "std::vector<UniquePtr<int>>", std_vector);
+    std::printf("%-44s %10.1f ms\n", "RelocatingVector<UniquePtr<int>> (realloc)", relocating);
+    std::printf("%-44s %10.1f ms\n", "RelocatingVector<UniquePtr<int, D>> (move)", moving);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "unique_array.h"
+
+#include <chrono>
+#include <cstdio>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// SAXPY over UniqueArray: 64-byte aligned buffers (the compiler may use aligned
+// vector loads) vs buffers deliberately shifted off a vector boundary
+
+using Clock = std::chrono::steady_clock;
+
+template <bool kAligned>
+[[gnu::noinline]] void Saxpy(float a, const float* x, float* y, size_t size) {
+    if constexpr (kAligned) {
+        x = static_cast<const float*>(__builtin_assume_aligned(x, 64));
+        y = static_cast<float*>(__builtin_assume_aligned(y, 64));
+    }
+    for (size_t i = 0; i < size; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+template <bool kAligned>
+double Measure(const float* x, float* y, size_t size) {
+    constexpr int kIterations = 2000;
+
+    auto start = Clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        Saxpy<kAligned>(0.5f, x, y, size);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / kIterations / size;
+}
+
+int main() {
+    std::printf("%-12s %14s %16s\n", "floats", "aligned ns/el", "unaligned ns/el");
+    for (size_t size : {1 << 10, 1 << 14, 1 << 18}) {
+        auto x = MakeAlignedUniqueArray<float, 64>(size + 1);
+        auto y = MakeAlignedUniqueArray<float, 64>(size + 1);
+        double aligned = Measure<true>(x.Get(), y.Get(), size);
+        double unaligned = Measure<false>(x.Get() + 1, y.Get() + 1, size);
+        std::printf("%-12zu %14.3f %16.3f\n", size, aligned, unaligned);
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Variadic counterpart of `CompressedPair`, with the same layout: every member
+// is `[[no_unique_address]]`, so an empty one, final or not, takes no space.
+//
+// Each member lives in its own `CompressedTupleElement<I, T>` base, and the
+// element of an empty type is itself empty, so the bases overlap. Two
+// subobjects of one type still need distinct addresses, so duplicate empty
+// types may cost a byte each, which is the best the language allows.
+
+namespace detail {
+
+template <size_t I, typename T>
+class CompressedTupleElement {
+public:
+    CompressedTupleElement() : value_() {
+    }
+
+    template <typename U>
+    explicit CompressedTupleElement(U&& value) : value_(std::forward<U>(value)) {
+    }
+
+    T& Get() {
+        return value_;
+    }
+
+    const T& Get() const {
+        return value_;
+    }
+
+private:
+    [[no_unique_address]] T value_;
+};
+
+template <size_t I, typename T, typename... Ts>
+struct TypeAt {
+    using Type = typename TypeAt<I - 1, Ts...>::Type;
+};
+
+template <typename T, typename... Ts>
+struct TypeAt<0, T, Ts...> {
+    using Type = T;
+};
+
+template <typename Indices, typename... Ts>
+class CompressedTupleImpl;
+
+template <size_t... Is, typename... Ts>
+class CompressedTupleImpl<std::index_sequence<Is...>, Ts...>
+    : public CompressedTupleElement<Is, Ts>... {
+public:
+    CompressedTupleImpl() = default;
+
+    template <typename... Args>
+    explicit CompressedTupleImpl(Args&&... args)
+        : CompressedTupleElement<Is, Ts>(std::forward<Args>(args))... {
+    }
+};
+
+}  // namespace detail
+
+template <typename... Ts>
+class CompressedTuple : private detail::CompressedTupleImpl<std::index_sequence_for<Ts...>, Ts...> {
+    using Impl = detail::CompressedTupleImpl<std::index_sequence_for<Ts...>, Ts...>;
+
+    template <size_t I>
+    using Element = detail::CompressedTupleElement<I, typename detail::TypeAt<I, Ts...>::Type>;
+
+public:
+    template <size_t I>
+    using Type = typename detail::TypeAt<I, Ts...>::Type;
+
+    static constexpr size_t kSize = sizeof...(Ts);
+
+    CompressedTuple() = default;
+
+    // One argument per member. The constraint keeps a single argument of
+    // tuple type going to the copy/move constructors.
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Ts) && sizeof...(Ts) > 0 &&
+                 (sizeof...(Args) != 1 ||
+                  !(std::is_same_v<std::remove_cvref_t<Args>, CompressedTuple> || ...)))
+    explicit CompressedTuple(Args&&... args) : Impl(std::forward<Args>(args)...) {
+    }
+
+    template <size_t I>
+    Type<I>& Get() {
+        return static_cast<Element<I>&>(*this).Get();
+    }
+
+    template <size_t I>
+    const Type<I>& Get() const {
+        return static_cast<const Element<I>&>(*this).Get();
+    }
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "unique.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Unmaps the file and closes its descriptor. Only an owner holding a mapping
+// does anything, so copies left behind in moved-from pointers are harmless.
+class FileMappingDeleter {
+public:
+    FileMappingDeleter() = default;
+
+    FileMappingDeleter(size_t length, int fd) : length_(length), fd_(fd) {
+    }
+
+    void operator()(const std::byte* data) {
+        if (data) {
+            munmap(const_cast<std::byte*>(data), length_);
+            close(fd_);
+        }
+    }
+
+    size_t Length() const {
+        return length_;
+    }
+
+    int Descriptor() const {
+        return fd_;
+    }
+
+private:
+    size_t length_ = 0;
+    int fd_ = -1;
+};
+
+// Read-only file mapped into memory: no copy into a heap buffer, pages are
+// shared with the page cache and faulted in on demand. All methods are const
+// and safe to call from several threads, so one mapping can be read by all
+// of them. `SharedPtr` counts are not atomic: copies of one may only be made
+// and dropped by one thread at a time, others get the `MappedFile` itself.
+class MappedFile {
+public:
+    enum class Access {
+        kNormal,
+        kSequential,  // MADV_SEQUENTIAL: aggressive read-ahead, pages dropped early
+        kRandom,      // MADV_RANDOM: no read-ahead
+        kWillNeed,    // MADV_WILLNEED: start reading the whole file in now
+    };
+
+    MappedFile() = default;
+
+    static MappedFile Open(const std::string& path, Access access = Access::kNormal) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat " + path);
+        }
+        size_t length = info.st_size;
+        if (length == 0) {
+            // Nothing to map, an empty mapping is not allowed
+            close(fd);
+            return MappedFile();
+        }
+        void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "mmap " + path);
+        }
+        MappedFile file(static_cast<const std::byte*>(data), FileMappingDeleter(length, fd));
+        file.Advise(access);
+        return file;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    const std::byte* Data() const {
+        return mapping_.Get();
+    }
+
+    size_t Size() const {
+        return mapping_ ? mapping_.GetDeleter().Length() : 0;
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    // Still open while the file is mapped, -1 for an empty file
+    int Descriptor() const {
+        return mapping_ ? mapping_.GetDeleter().Descriptor() : -1;
+    }
+
+    // Zero-copy typed view of the bytes starting at `offset`
+    template <typename T>
+    std::span<const T> View(size_t offset = 0) const {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Only trivially copyable types can be viewed");
+        if (offset > Size()) {
+            throw std::out_of_range("MappedFile::View");
+        }
+        const std::byte* begin = Data() + offset;
+        if (reinterpret_cast<uintptr_t>(begin) % alignof(T) != 0) {
+            throw std::invalid_argument("MappedFile::View: misaligned offset");
+        }
+        return {reinterpret_cast<const T*>(begin), (Size() - offset) / sizeof(T)};
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Prefetch hints
+
+    void Advise(Access access) const {
+        Advise(access, 0, Size());
+    }
+
+    // The range is clipped to the file, and `offset` is rounded down to a page
+    // boundary as `madvise` requires. Only a hint: errors are ignored.
+    void Advise(Access access, size_t offset, size_t length) const {
+        if (offset >= Size() || access == Access::kNormal) {
+            return;
+        }
+        if (length > Size() - offset) {
+            length = Size() - offset;
+        }
+        size_t page_size = sysconf(_SC_PAGESIZE);
+        size_t aligned = offset / page_size * page_size;
+        madvise(const_cast<std::byte*>(Data()) + aligned, length + offset - aligned,
+                ToAdvice(access));
+    }
+
+private:
+    MappedFile(const std::byte* data, FileMappingDeleter deleter) : mapping_(data, deleter) {
+    }
+
+    static int ToAdvice(Access access) {
+        switch (access) {
+            case Access::kSequential:
+                return MADV_SEQUENTIAL;
+            case Access::kRandom:
+                return MADV_RANDOM;
+            case Access::kWillNeed:
+                return MADV_WILLNEED;
+            default:
+                return MADV_NORMAL;
+        }
+    }
+
+    UniquePtr<const std::byte[], FileMappingDeleter> mapping_;
+};
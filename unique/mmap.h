@@ -0,0 +1,116 @@
+#pragma once
+
+#include "unique.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Anonymous memory mappings owned by `UniquePtr<T[], ...>`. Meant for large
+// tables of trivial types: the memory comes zero-filled from the kernel, so
+// elements are never constructed or destroyed.
+
+struct MmapOptions {
+    // Ask for transparent huge pages (MADV_HUGEPAGE) to cut TLB misses
+    bool huge_pages = false;
+    // Fault all pages in up front (MAP_POPULATE) instead of on first touch
+    bool populate = false;
+};
+
+// Unmaps `length` bytes. Stateful, so the UniquePtr is two words.
+template <typename T>
+class MmapDeleter {
+public:
+    MmapDeleter() = default;
+
+    explicit MmapDeleter(size_t length) : length_(length) {
+    }
+
+    void operator()(T* pointer) {
+        if (pointer) {
+            munmap(pointer, length_);
+        }
+    }
+
+    size_t Length() const {
+        return length_;
+    }
+
+private:
+    size_t length_ = 0;
+};
+
+// Mapping of a length known at compile time. Empty, so `CompressedPair` keeps
+// the UniquePtr at one word.
+template <typename T, size_t Length>
+struct StaticMmapDeleter {
+    void operator()(T* pointer) {
+        if (pointer) {
+            munmap(pointer, Length);
+        }
+    }
+};
+
+namespace detail {
+
+inline void* MapAnonymous(size_t length, MmapOptions options) {
+    // With huge pages, populating must wait until after `madvise`, or the
+    // kernel would already have faulted everything in as small pages
+    bool populate_after_advice = options.populate && options.huge_pages;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+    if (options.populate && !populate_after_advice) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+#ifdef MADV_HUGEPAGE
+    // Advisory only: kernels without THP just keep regular pages
+    if (options.huge_pages) {
+        madvise(memory, length, MADV_HUGEPAGE);
+    }
+#endif
+    if (populate_after_advice) {
+        size_t page_size = sysconf(_SC_PAGESIZE);
+        for (size_t offset = 0; offset < length; offset += page_size) {
+            static_cast<volatile char*>(memory)[offset] = 0;
+        }
+    }
+    return memory;
+}
+
+}  // namespace detail
+
+// An empty array maps nothing (`mmap` rejects a zero length) and comes back
+// as a null pointer
+template <typename T>
+UniquePtr<T[], MmapDeleter<T>> MakeMmapArray(size_t size, MmapOptions options = {}) {
+    static_assert(std::is_trivial_v<T>, "Mapped arrays hold trivial types only");
+    if (size == 0) {
+        return UniquePtr<T[], MmapDeleter<T>>();
+    }
+    if (size > SIZE_MAX / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    size_t length = size * sizeof(T);
+    void* memory = detail::MapAnonymous(length, options);
+    return UniquePtr<T[], MmapDeleter<T>>(static_cast<T*>(memory), MmapDeleter<T>(length));
+}
+
+template <typename T, size_t Size>
+UniquePtr<T[], StaticMmapDeleter<T, Size * sizeof(T)>> MakeStaticMmapArray(
+    MmapOptions options = {}) {
+    static_assert(std::is_trivial_v<T>, "Mapped arrays hold trivial types only");
+    static_assert(Size <= SIZE_MAX / sizeof(T), "Mapped array too large");
+    void* memory = detail::MapAnonymous(Size * sizeof(T), options);
+    return UniquePtr<T[], StaticMmapDeleter<T, Size * sizeof(T)>>(static_cast<T*>(memory));
+}
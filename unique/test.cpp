@@ -2,11 +2,14 @@
 
 #include "deleters.h"
 
+#include <common/relocating_vector.h>
+
 #include <common/my_int.h>
 
 #include <catch.hpp>
 #include <vector>
 #include <tuple>
+#include <stdexcept>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -462,6 +465,16 @@ TEST_CASE("Compressed pair usage") {
         static_assert(sizeof(UniquePtr<int, decltype(&DeleteFunction<int>)>) ==
                       sizeof(std::pair<int*, decltype(&DeleteFunction<int>)>));
     }
+
+    SECTION("Final stateless deleter") {
+        struct FinalDeleter final {
+            void operator()(int* ptr) {
+                delete ptr;
+            }
+        };
+        static_assert(sizeof(UniquePtr<int, FinalDeleter>) == sizeof(int*));
+        static_assert(sizeof(CompressedPair<Slug<int>, Slug<int>>) == 2);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -504,3 +517,224 @@ TEST_CASE("Upcasts") {
         s2 = std::move(s);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class CountingArena {
+public:
+    void* Allocate(size_t size, size_t alignment) {
+        ++allocated;
+        bytes += size;
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void Deallocate(void* pointer, size_t size, size_t alignment) {
+        ++deallocated;
+        bytes -= size;
+        ::operator delete(pointer, std::align_val_t(alignment));
+    }
+
+    int allocated = 0;
+    int deallocated = 0;
+    size_t bytes = 0;
+};
+
+struct ThrowingInt {
+    ThrowingInt(int) {
+        throw std::runtime_error("nope");
+    }
+};
+
+TEST_CASE("Factories") {
+    SECTION("MakeUnique") {
+        auto s = MakeUnique<MyInt>(42);
+        REQUIRE(MyInt::AliveCount() == 1);
+        REQUIRE(*s == 42);
+
+        auto alice = MakeUnique<Alice>();
+        UniquePtr<Person> person = std::move(alice);
+        REQUIRE(person->GetFavoriteNumber() == 37);
+    }
+
+    SECTION("MakeUnique for arrays value-initializes") {
+        auto arr = MakeUnique<int[]>(100);
+        for (size_t i = 0; i < 100; ++i) {
+            REQUIRE(arr[i] == 0);
+        }
+
+        auto objects = MakeUnique<MyInt[]>(10);
+        REQUIRE(MyInt::AliveCount() == 10);
+        objects.Reset();
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+
+    SECTION("MakeUniqueForOverwrite") {
+        auto value = MakeUniqueForOverwrite<int>();
+        *value = 5;
+        REQUIRE(*value == 5);
+
+        auto buffer = MakeUniqueForOverwrite<char[]>(1 << 20);
+        buffer[0] = 'a';
+        REQUIRE(buffer[0] == 'a');
+
+        auto objects = MakeUniqueForOverwrite<MyInt[]>(3);
+        REQUIRE(MyInt::AliveCount() == 3);
+    }
+
+    SECTION("MakeUniqueIn") {
+        CountingArena arena;
+        {
+            auto s = MakeUniqueIn<MyInt>(arena, 7);
+            REQUIRE(*s == 7);
+            REQUIRE(MyInt::AliveCount() == 1);
+            REQUIRE(arena.allocated == 1);
+            REQUIRE(arena.bytes == sizeof(MyInt));
+            REQUIRE(s.GetDeleter().GetArena() == &arena);
+
+            auto moved = std::move(s);
+            REQUIRE(arena.deallocated == 0);
+        }
+        REQUIRE(MyInt::AliveCount() == 0);
+        REQUIRE(arena.deallocated == 1);
+        REQUIRE(arena.bytes == 0);
+    }
+
+    SECTION("MakeUniqueIn with throwing constructor") {
+        CountingArena arena;
+        REQUIRE_THROWS_AS(MakeUniqueIn<ThrowingInt>(arena, 1), std::runtime_error);
+        REQUIRE(arena.allocated == 1);
+        REQUIRE(arena.deallocated == 1);
+    }
+
+    SECTION("Arena deleter stores the arena pointer") {
+        static_assert(sizeof(UniquePtr<MyInt, ArenaDeleter<MyInt, CountingArena>>) ==
+                      2 * sizeof(void*));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Every allocation made during constant evaluation must be freed before it
+// ends, so these only compile if the owners really destroy what they hold
+
+constexpr int SumSquares(int n) {
+    UniquePtr<int[]> squares(new int[n]);
+    for (int i = 0; i < n; ++i) {
+        squares[i] = i * i;
+    }
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += squares[i];
+    }
+    return sum;
+}
+
+constexpr int MoveAround() {
+    auto first = MakeUnique<int>(1);
+    UniquePtr<int> second(std::move(first));
+    UniquePtr<int> third(new int(2));
+    third = std::move(second);
+    third.Swap(first);
+    first.Reset(new int(*first + 2));
+    int* raw = first.Release();
+    int result = *raw + (second ? 100 : 0) + (third ? 1000 : 0);
+    delete raw;
+    return result;
+}
+
+struct ConstexprDeleter {
+    int deleted = 0;
+
+    constexpr void operator()(int* pointer) {
+        if (pointer) {
+            ++deleted;
+            delete pointer;
+        }
+    }
+};
+
+constexpr int StatefulDeleterCount() {
+    UniquePtr<int, ConstexprDeleter> ptr(new int(1));
+    ptr.Reset(new int(2));
+    ptr = nullptr;
+    return ptr.GetDeleter().deleted;
+}
+
+constexpr bool PairWorks() {
+    CompressedPair<int, Slug<int>> ebo(1, Slug<int>{});
+    CompressedPair<int, ConstexprDeleter> plain(2, ConstexprDeleter{3});
+    CompressedPair<Slug<int>, Slug<int[]>> empty;
+    (void)empty.GetFirst();
+    return ebo.GetFirst() == 1 && plain.GetFirst() == 2 && plain.GetSecond().deleted == 3;
+}
+
+TEST_CASE("Constant evaluation") {
+    static_assert(SumSquares(10) == 285);
+    static_assert(MoveAround() == 3);
+    static_assert(StatefulDeleterCount() == 2);
+    static_assert(PairWorks());
+
+    // Same code at run time
+    REQUIRE(SumSquares(10) == 285);
+    REQUIRE(MoveAround() == 3);
+    REQUIRE(StatefulDeleterCount() == 2);
+}
+
+TEST_CASE("Noexcept moves") {
+    struct ThrowingDeleter {
+        ThrowingDeleter() = default;
+        ThrowingDeleter(ThrowingDeleter&&) noexcept(false) {
+        }
+        ThrowingDeleter& operator=(ThrowingDeleter&&) noexcept(false) {
+            return *this;
+        }
+        void operator()(int* pointer) {
+            delete pointer;
+        }
+    };
+
+    static_assert(std::is_nothrow_move_constructible_v<UniquePtr<int[]>>);
+    static_assert(std::is_nothrow_move_assignable_v<UniquePtr<int[]>>);
+    static_assert(std::is_nothrow_move_constructible_v<UniquePtr<int, Deleter<int>>>);
+    static_assert(std::is_nothrow_move_constructible_v<CompressedPair<int*, Slug<int>>>);
+    static_assert(!std::is_nothrow_move_constructible_v<UniquePtr<int, ThrowingDeleter>>);
+    static_assert(!std::is_nothrow_move_assignable_v<UniquePtr<int, ThrowingDeleter>>);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Trivial relocation") {
+    SECTION("Trait") {
+        static_assert(kIsTriviallyRelocatable<UniquePtr<int>>);
+        static_assert(kIsTriviallyRelocatable<UniquePtr<int[]>>);
+        static_assert(kIsTriviallyRelocatable<UniquePtr<int, StatefulDeleter<int>>>);
+        static_assert(!kIsTriviallyRelocatable<UniquePtr<int, Deleter<int>>>);
+    }
+
+    SECTION("Growth keeps ownership") {
+        RelocatingVector<UniquePtr<MyInt>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.EmplaceBack(new MyInt(i));
+        }
+        REQUIRE(v.Size() == 1000);
+        REQUIRE(MyInt::AliveCount() == 1000);
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE(*v[i] == i);
+        }
+        v.PopBack();
+        REQUIRE(MyInt::AliveCount() == 999);
+        v.Clear();
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+
+    SECTION("Non-relocatable deleters are moved") {
+        RelocatingVector<UniquePtr<MyInt, Deleter<MyInt>>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(new MyInt(i), Deleter<MyInt>(i + 1));
+        }
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(*v[i] == i);
+            REQUIRE(v[i].GetDeleter().GetTag() == i + 1);
+        }
+    }
+}
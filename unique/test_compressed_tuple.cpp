@@ -0,0 +1,96 @@
+#include "compressed_tuple.h"
+
+#include "compressed_pair.h"
+
+#include <catch.hpp>
+
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Empty {};
+
+struct AnotherEmpty {};
+
+struct FinalEmpty final {};
+
+struct StatelessDeleter {
+    int Tag() const {
+        return 7;
+    }
+};
+
+struct Allocator {
+    Allocator() = default;
+
+    explicit Allocator(int id) : id(id) {
+    }
+
+    int id = 0;
+};
+
+}  // namespace
+
+TEST_CASE("CompressedTuple sizes") {
+    static_assert(sizeof(CompressedTuple<int*>) == sizeof(int*));
+    static_assert(sizeof(CompressedTuple<int*, Empty>) == sizeof(int*));
+    static_assert(sizeof(CompressedTuple<Empty, int*>) == sizeof(int*));
+    static_assert(sizeof(CompressedTuple<int*, StatelessDeleter, Empty>) == sizeof(int*));
+    static_assert(sizeof(CompressedTuple<Empty, AnotherEmpty, int*, size_t>) == 2 * sizeof(void*));
+
+    // Final types take no space either
+    static_assert(sizeof(CompressedTuple<int*, FinalEmpty>) == sizeof(int*));
+
+    // Repeated empty types still compile, each needs its own address
+    static_assert(sizeof(CompressedTuple<int*, Empty, Empty>) <= 2 * sizeof(int*));
+
+    // Same layout as the pair it generalizes
+    static_assert(sizeof(CompressedTuple<int*, StatelessDeleter>) ==
+                  sizeof(CompressedPair<int*, StatelessDeleter>));
+    static_assert(sizeof(CompressedTuple<int*, FinalEmpty>) ==
+                  sizeof(CompressedPair<int*, FinalEmpty>));
+    static_assert(sizeof(CompressedTuple<Empty, Empty>) == sizeof(CompressedPair<Empty, Empty>));
+}
+
+TEST_CASE("CompressedTuple access") {
+    SECTION("Construction and Get") {
+        int value = 5;
+        CompressedTuple<int*, StatelessDeleter, Allocator, size_t> tuple(&value, StatelessDeleter{},
+                                                                         Allocator(3), 10);
+        REQUIRE(tuple.Get<0>() == &value);
+        REQUIRE(tuple.Get<1>().Tag() == 7);
+        REQUIRE(tuple.Get<2>().id == 3);
+        REQUIRE(tuple.Get<3>() == 10);
+
+        tuple.Get<3>() = 20;
+        const auto& ref = tuple;
+        REQUIRE(ref.Get<3>() == 20);
+        static_assert(std::is_same_v<decltype(ref.Get<0>()), int* const&>);
+        static_assert(decltype(tuple)::kSize == 4);
+    }
+
+    SECTION("Default construction value-initializes") {
+        CompressedTuple<int*, Empty, size_t> tuple;
+        REQUIRE(tuple.Get<0>() == nullptr);
+        REQUIRE(tuple.Get<2>() == 0);
+    }
+
+    SECTION("Copy and move") {
+        CompressedTuple<std::string, Empty> tuple(std::string("payload"), Empty{});
+        auto copy = tuple;
+        auto moved = std::move(tuple);
+        REQUIRE(copy.Get<0>() == "payload");
+        REQUIRE(moved.Get<0>() == "payload");
+
+        CompressedTuple<std::string> single(std::string("one"));
+        auto single_copy = single;
+        REQUIRE(single_copy.Get<0>() == "one");
+    }
+
+    SECTION("Duplicate empty types are distinct members") {
+        CompressedTuple<Empty, Empty, int> tuple;
+        REQUIRE(static_cast<void*>(&tuple.Get<0>()) != static_cast<void*>(&tuple.Get<1>()));
+    }
+}
@@ -0,0 +1,189 @@
+#include "inline_unique.h"
+
+#include <catch.hpp>
+
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+int alive = 0;
+
+struct Strategy {
+    Strategy() {
+        ++alive;
+    }
+    Strategy(const Strategy&) noexcept {
+        ++alive;
+    }
+    virtual ~Strategy() {
+        --alive;
+    }
+    virtual int Apply(int x) const = 0;
+};
+
+struct Add : Strategy {
+    explicit Add(int delta) : delta(delta) {
+    }
+    int Apply(int x) const override {
+        return x + delta;
+    }
+    int delta;
+};
+
+// Too big for the default inline buffer
+struct Table : Strategy {
+    int Apply(int x) const override {
+        return values[x % 64];
+    }
+    int values[64] = {};
+};
+
+// Not nothrow movable, so it goes to the heap however small it is
+struct Named : Strategy {
+    explicit Named(std::string name) : name(std::move(name)) {
+    }
+    Named(Named&& other) noexcept(false) : Strategy(other), name(std::move(other.name)) {
+    }
+    int Apply(int x) const override {
+        return x + static_cast<int>(name.size());
+    }
+    std::string name;
+};
+
+// `Strategy` is not the first base, so it does not start at the buffer start
+struct Tagged {
+    virtual ~Tagged() = default;
+    long tag = 0;
+};
+
+struct Offset : Tagged, Add {
+    explicit Offset(int delta) : Add(delta) {
+    }
+};
+
+}  // namespace
+
+TEST_CASE("InlineUniquePtr storage") {
+    SECTION("Small objects stay inline") {
+        auto ptr = MakeInlineUnique<Strategy, Add>(5);
+        REQUIRE(ptr);
+        REQUIRE(ptr.IsInline());
+        REQUIRE(ptr->Apply(1) == 6);
+        auto* begin = reinterpret_cast<const char*>(&ptr);
+        auto* object = reinterpret_cast<const char*>(ptr.Get());
+        REQUIRE(object >= begin);
+        REQUIRE(object < begin + sizeof(ptr));
+    }
+
+    SECTION("Large objects go to the heap") {
+        auto ptr = MakeInlineUnique<Strategy, Table>();
+        REQUIRE(!ptr.IsInline());
+        REQUIRE(ptr->Apply(3) == 0);
+    }
+
+    SECTION("Throwing moves go to the heap") {
+        static_assert(!InlineUniquePtr<Strategy, 256>::kFitsInline<Named>);
+        InlineUniquePtr<Strategy, 256> ptr;
+        ptr.Emplace<Named>("abc");
+        REQUIRE(!ptr.IsInline());
+        REQUIRE(ptr->Apply(1) == 4);
+    }
+
+    SECTION("Larger buffer") {
+        InlineUniquePtr<Strategy, sizeof(Table)> ptr;
+        ptr.Emplace<Table>().values[3] = 7;
+        REQUIRE(ptr.IsInline());
+        REQUIRE(ptr->Apply(3) == 7);
+    }
+
+    REQUIRE(alive == 0);
+}
+
+TEST_CASE("InlineUniquePtr moves") {
+    SECTION("Move construction relocates inline objects") {
+        auto first = MakeInlineUnique<Strategy, Add>(2);
+        InlineUniquePtr<Strategy> second(std::move(first));
+        REQUIRE(!first);
+        REQUIRE(!first.IsInline());
+        REQUIRE(second.IsInline());
+        REQUIRE(second->Apply(1) == 3);
+        REQUIRE(alive == 1);
+    }
+
+    SECTION("Move construction steals heap objects") {
+        auto first = MakeInlineUnique<Strategy, Table>();
+        Strategy* object = first.Get();
+        InlineUniquePtr<Strategy> second(std::move(first));
+        REQUIRE(second.Get() == object);
+        REQUIRE(!first);
+    }
+
+    SECTION("Move assignment destroys the old object") {
+        auto first = MakeInlineUnique<Strategy, Add>(1);
+        auto second = MakeInlineUnique<Strategy, Table>();
+        REQUIRE(alive == 2);
+        second = std::move(first);
+        REQUIRE(alive == 1);
+        REQUIRE(second->Apply(1) == 2);
+        second = nullptr;
+        REQUIRE(alive == 0);
+    }
+
+    SECTION("Swap") {
+        auto first = MakeInlineUnique<Strategy, Add>(1);
+        auto second = MakeInlineUnique<Strategy, Table>();
+        first.Swap(second);
+        REQUIRE(!first.IsInline());
+        REQUIRE(second.IsInline());
+        REQUIRE(second->Apply(1) == 2);
+    }
+
+    SECTION("Self-move") {
+        auto ptr = MakeInlineUnique<Strategy, Add>(1);
+        auto& same = ptr;
+        ptr = std::move(same);
+        REQUIRE(ptr->Apply(1) == 2);
+    }
+
+    REQUIRE(alive == 0);
+}
+
+TEST_CASE("InlineUniquePtr upcasts") {
+    SECTION("Derived to base") {
+        InlineUniquePtr<Add> derived;
+        derived.Emplace<Add>(4);
+        InlineUniquePtr<Strategy> base(std::move(derived));
+        REQUIRE(base.IsInline());
+        REQUIRE(base->Apply(0) == 4);
+    }
+
+    SECTION("Into a larger buffer") {
+        auto small = MakeInlineUnique<Strategy, Add>(4);
+        InlineUniquePtr<Strategy, 128> large(std::move(small));
+        REQUIRE(large.IsInline());
+        REQUIRE(large->Apply(0) == 4);
+        static_assert(!std::is_constructible_v<InlineUniquePtr<Strategy>,
+                                               InlineUniquePtr<Strategy, 128>&&>);
+    }
+
+    SECTION("Base subobject at an offset") {
+        InlineUniquePtr<Offset, 64> derived;
+        derived.Emplace<Offset>(3);
+        InlineUniquePtr<Strategy, 64> base(std::move(derived));
+        REQUIRE(base.IsInline());
+        REQUIRE(base->Apply(1) == 4);
+        InlineUniquePtr<Strategy, 64> moved(std::move(base));
+        REQUIRE(moved->Apply(1) == 4);
+        REQUIRE(dynamic_cast<Offset*>(moved.Get())->tag == 0);
+    }
+
+    SECTION("From UniquePtr") {
+        InlineUniquePtr<Strategy> ptr(MakeUnique<Add>(6));
+        REQUIRE(!ptr.IsInline());
+        REQUIRE(ptr->Apply(0) == 6);
+    }
+
+    REQUIRE(alive == 0);
+}
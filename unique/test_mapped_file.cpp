@@ -0,0 +1,113 @@
+#include "mapped_file.h"
+
+#include <shared/shared.h>
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class TempFile {
+public:
+    explicit TempFile(const std::vector<uint32_t>& contents) {
+        char path[] = "/tmp/mapped_file_testXXXXXX";
+        int fd = mkstemp(path);
+        REQUIRE(fd >= 0);
+        size_t length = contents.size() * sizeof(uint32_t);
+        REQUIRE(write(fd, contents.data(), length) == static_cast<ssize_t>(length));
+        close(fd);
+        path_ = path;
+    }
+
+    ~TempFile() {
+        std::remove(path_.c_str());
+    }
+
+    const std::string& Path() const {
+        return path_;
+    }
+
+private:
+    std::string path_;
+};
+
+TEST_CASE("MappedFile") {
+    std::vector<uint32_t> contents(100000);
+    std::iota(contents.begin(), contents.end(), 0);
+    TempFile file(contents);
+
+    SECTION("Typed view") {
+        auto mapped = MappedFile::Open(file.Path(), MappedFile::Access::kSequential);
+        REQUIRE(mapped.Size() == contents.size() * sizeof(uint32_t));
+
+        auto view = mapped.View<uint32_t>();
+        REQUIRE(view.size() == contents.size());
+        REQUIRE(std::equal(view.begin(), view.end(), contents.begin()));
+
+        auto tail = mapped.View<uint32_t>(400);
+        REQUIRE(tail.front() == 100);
+        REQUIRE_THROWS_AS(mapped.View<uint32_t>(2), std::invalid_argument);
+        REQUIRE_THROWS_AS(mapped.View<uint32_t>(mapped.Size() + 1), std::out_of_range);
+
+        mapped.Advise(MappedFile::Access::kWillNeed, 5000, 10000);
+        // Clipped to the file, no overflow
+        mapped.Advise(MappedFile::Access::kWillNeed, 100, SIZE_MAX);
+        mapped.Advise(MappedFile::Access::kWillNeed, mapped.Size(), 1);
+        mapped.Advise(MappedFile::Access::kRandom);
+    }
+
+    SECTION("Move") {
+        auto mapped = MappedFile::Open(file.Path());
+        const std::byte* data = mapped.Data();
+        MappedFile moved = std::move(mapped);
+        REQUIRE(mapped.Empty());
+        REQUIRE(moved.Data() == data);
+        REQUIRE(moved.View<uint32_t>()[7] == 7);
+    }
+
+    SECTION("Descriptor is closed with the mapping") {
+        int fd;
+        {
+            auto mapped = MappedFile::Open(file.Path());
+            fd = mapped.Descriptor();
+            REQUIRE(fcntl(fd, F_GETFD) != -1);
+        }
+        REQUIRE(fcntl(fd, F_GETFD) == -1);
+    }
+
+    SECTION("Shared between threads") {
+        SharedPtr<const MappedFile> shared = MakeShared<const MappedFile>(
+            MappedFile::Open(file.Path(), MappedFile::Access::kWillNeed));
+        // The owner stays on this thread, the workers only read the mapping
+        const MappedFile& mapped = *shared;
+        std::vector<uint64_t> sums(4);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < sums.size(); ++i) {
+            threads.emplace_back([&mapped, &sum = sums[i]] {
+                auto view = mapped.View<uint32_t>();
+                sum = std::accumulate(view.begin(), view.end(), uint64_t{0});
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (uint64_t sum : sums) {
+            REQUIRE(sum == uint64_t{99999} * 100000 / 2);
+        }
+    }
+
+    SECTION("Empty and missing files") {
+        TempFile empty({});
+        auto mapped = MappedFile::Open(empty.Path());
+        REQUIRE(mapped.Empty());
+        REQUIRE(mapped.View<uint32_t>().empty());
+
+        REQUIRE_THROWS_AS(MappedFile::Open("/nonexistent/file"), std::system_error);
+    }
+}
@@ -0,0 +1,58 @@
+#include "mmap.h"
+
+#include <catch.hpp>
+
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Mapped arrays") {
+    SECTION("Zero-filled and writable") {
+        constexpr size_t kSize = 1 << 20;
+        auto table = MakeMmapArray<uint64_t>(kSize);
+        REQUIRE(table.GetDeleter().Length() == kSize * sizeof(uint64_t));
+        for (size_t i = 0; i < kSize; i += 4096) {
+            REQUIRE(table[i] == 0);
+            table[i] = i;
+        }
+        REQUIRE(table[4096 * 3] == 4096 * 3);
+    }
+
+    SECTION("Options") {
+        auto table = MakeMmapArray<int>(1 << 22, {.huge_pages = true, .populate = true});
+        table[(1 << 22) - 1] = 42;
+        REQUIRE(table[(1 << 22) - 1] == 42);
+    }
+
+    SECTION("Move and reset") {
+        auto table = MakeMmapArray<char>(4096);
+        auto moved = std::move(table);
+        REQUIRE(!table);
+        moved[0] = 'x';
+        moved.Reset();
+        REQUIRE(!moved);
+    }
+
+    SECTION("Empty") {
+        auto empty = MakeMmapArray<char>(0);
+        REQUIRE(!empty);
+        REQUIRE(empty.GetDeleter().Length() == 0);
+        empty.Reset();
+    }
+
+    SECTION("Failure throws") {
+        REQUIRE_THROWS_AS(MakeMmapArray<char>(SIZE_MAX), std::system_error);
+        // The byte count would wrap around to 4
+        REQUIRE_THROWS_AS(MakeMmapArray<int>(SIZE_MAX / sizeof(int) + 2),
+                          std::bad_array_new_length);
+    }
+
+    SECTION("Sizes") {
+        static_assert(sizeof(UniquePtr<int[], MmapDeleter<int>>) == 2 * sizeof(void*));
+        static_assert(sizeof(UniquePtr<int[], StaticMmapDeleter<int, 4096>>) == sizeof(void*));
+
+        auto page = MakeStaticMmapArray<int, 1024>();
+        page[1023] = 1;
+        REQUIRE(page[1023] == 1);
+    }
+}
@@ -0,0 +1,122 @@
+#include "unique_any.h"
+
+#include <common/my_int.h>
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Task {
+    virtual ~Task() = default;
+};
+
+struct PrintTask : Task {
+    std::string text;
+};
+
+}  // namespace
+
+TEST_CASE("UniqueAny basics") {
+    static_assert(sizeof(UniqueAny) == 2 * sizeof(void*));
+
+    SECTION("Empty") {
+        UniqueAny any;
+        REQUIRE(!any);
+        REQUIRE(any.Get() == nullptr);
+        REQUIRE(any.Get<int>() == nullptr);
+        REQUIRE(any.Type() == typeid(void));
+        REQUIRE(any.Size() == 0);
+    }
+
+    SECTION("Owns and destroys") {
+        {
+            auto any = MakeUniqueAny<MyInt>(5);
+            REQUIRE(MyInt::AliveCount() == 1);
+            REQUIRE(any.Type() == typeid(MyInt));
+            REQUIRE(any.Size() == sizeof(MyInt));
+            REQUIRE(any.Alignment() == alignof(MyInt));
+            REQUIRE(*any.Get<MyInt>() == 5);
+        }
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+
+    SECTION("From UniquePtr") {
+        UniquePtr<MyInt> ptr(new MyInt(3));
+        MyInt* raw = ptr.Get();
+        UniqueAny any(std::move(ptr));
+        REQUIRE(!ptr);
+        REQUIRE(any.Get() == raw);
+        any = nullptr;
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+
+    SECTION("Empty UniquePtr stays empty") {
+        UniqueAny any(UniquePtr<int>{});
+        REQUIRE(!any);
+        REQUIRE(any.Type() == typeid(void));
+    }
+}
+
+TEST_CASE("UniqueAny checked downcasts") {
+    auto any = MakeUniqueAny<std::string>("abc");
+    REQUIRE(any.Is<std::string>());
+    REQUIRE(any.Is<const std::string>());
+    REQUIRE(!any.Is<int>());
+    REQUIRE(any.Get<int>() == nullptr);
+    REQUIRE(*any.Get<std::string>() == "abc");
+
+    SECTION("Exact type only") {
+        auto task = MakeUniqueAny<PrintTask>();
+        REQUIRE(task.Get<PrintTask>() != nullptr);
+        REQUIRE(task.Get<Task>() == nullptr);
+    }
+
+    SECTION("Release of the wrong type keeps ownership") {
+        auto wrong = any.Release<int>();
+        REQUIRE(!wrong);
+        REQUIRE(any);
+        auto right = any.Release<std::string>();
+        REQUIRE(*right == "abc");
+        REQUIRE(!any);
+    }
+}
+
+TEST_CASE("UniqueAny moves") {
+    SECTION("Move construction and assignment") {
+        auto first = MakeUniqueAny<MyInt>(1);
+        UniqueAny second(std::move(first));
+        REQUIRE(!first);
+        REQUIRE(*second.Get<MyInt>() == 1);
+        auto third = MakeUniqueAny<MyInt>(2);
+        third = std::move(second);
+        REQUIRE(MyInt::AliveCount() == 1);
+        REQUIRE(*third.Get<MyInt>() == 1);
+    }
+
+    SECTION("Swap") {
+        auto first = MakeUniqueAny<int>(1);
+        auto second = MakeUniqueAny<std::string>("two");
+        first.Swap(second);
+        REQUIRE(*first.Get<std::string>() == "two");
+        REQUIRE(*second.Get<int>() == 1);
+    }
+
+    SECTION("Heterogeneous queue") {
+        std::vector<UniqueAny> queue;
+        queue.push_back(MakeUniqueAny<int>(1));
+        queue.push_back(MakeUniqueAny<MyInt>(2));
+        queue.push_back(MakeUniqueAny<std::string>("three"));
+        queue.erase(queue.begin());
+        REQUIRE(queue.size() == 2);
+        REQUIRE(*queue[0].Get<MyInt>() == 2);
+        REQUIRE(*queue[1].Get<std::string>() == "three");
+        queue.clear();
+    }
+
+    REQUIRE(MyInt::AliveCount() == 0);
+}
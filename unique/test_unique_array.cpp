@@ -0,0 +1,80 @@
+#include "unique_array.h"
+
+#include <common/my_int.h>
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <span>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Sum(std::span<const int> values) {
+    return std::accumulate(values.begin(), values.end(), 0);
+}
+
+TEST_CASE("UniqueArray") {
+    SECTION("Size and access") {
+        auto arr = MakeUniqueArray<int>(10);
+        REQUIRE(arr.Size() == 10);
+        REQUIRE(!arr.Empty());
+        for (size_t i = 0; i < arr.Size(); ++i) {
+            REQUIRE(arr[i] == 0);
+            arr[i] = i;
+        }
+        REQUIRE(arr.At(9) == 9);
+        REQUIRE_THROWS_AS(arr.At(10), std::out_of_range);
+    }
+
+    SECTION("Iterators and span") {
+        auto arr = MakeUniqueArrayForOverwrite<int>(5);
+        std::iota(arr.begin(), arr.end(), 1);
+        REQUIRE(Sum(arr) == 15);
+
+        std::span<int> span = arr;
+        REQUIRE(span.size() == 5);
+        REQUIRE(span.data() == arr.Get());
+    }
+
+    SECTION("Move") {
+        auto arr = MakeUniqueArray<MyInt>(3);
+        REQUIRE(MyInt::AliveCount() == 3);
+        auto moved = std::move(arr);
+        REQUIRE(arr.Size() == 0);
+        REQUIRE(!arr);
+        REQUIRE(moved.Size() == 3);
+        REQUIRE(MyInt::AliveCount() == 3);
+        moved.Reset();
+        REQUIRE(MyInt::AliveCount() == 0);
+        REQUIRE(moved.Size() == 0);
+    }
+
+    SECTION("Adopting an array UniquePtr") {
+        UniqueArray<MyInt> arr(UniquePtr<MyInt[]>(new MyInt[4]), 4);
+        REQUIRE(arr.Size() == 4);
+        UniquePtr<MyInt[]> released = arr.Release();
+        REQUIRE(arr.Empty());
+        REQUIRE(MyInt::AliveCount() == 4);
+    }
+
+    SECTION("Aligned") {
+        auto floats = MakeAlignedUniqueArray<float, 64>(1000);
+        REQUIRE(reinterpret_cast<uintptr_t>(floats.Get()) % 64 == 0);
+        REQUIRE(floats.Size() == 1000);
+        REQUIRE(floats[999] == 0.0f);
+
+        auto bytes = MakeAlignedUniqueArrayForOverwrite<uint8_t, 32>(7);
+        REQUIRE(reinterpret_cast<uintptr_t>(bytes.Get()) % 32 == 0);
+
+        static_assert(sizeof(AlignedUniqueArray<float, 64>) == 2 * sizeof(void*));
+    }
+
+    SECTION("Aligned size overflow") {
+        // The byte count wraps around to 4
+        size_t size = SIZE_MAX / sizeof(float) + 2;
+        REQUIRE_THROWS_AS((MakeAlignedUniqueArray<float, 64>(size)), std::bad_array_new_length);
+        REQUIRE_THROWS_AS((MakeAlignedUniqueArrayForOverwrite<float, 64>(size)),
+                          std::bad_array_new_length);
+    }
+}
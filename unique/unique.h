@@ -2,67 +2,69 @@
 
 #include "compressed_pair.h"
 
+#include <common/relocatable.h>
+#include <common/trivial_abi.h>
+
 #include <cstddef>  // std::nullptr_t
+#include <new>
 #include <type_traits>
+#include <utility>
 
 template <typename T>
 struct Slug {
-    Slug() = default;
+    constexpr Slug() = default;
 
     template <typename S>
-    Slug(const S& dummy) {
+    constexpr Slug(const S& dummy) {
     }
 
-    void operator()(T* pointer) {
+    constexpr void operator()(T* pointer) {
         delete pointer;
     }
 };
 
 template <typename T>
 struct Slug<T[]> {
-    Slug() = default;
+    constexpr Slug() = default;
 
     template <typename S>
-    Slug(const S& dummy) {
+    constexpr Slug(const S& dummy) {
     }
 
-    void operator()(T* pointer) {
+    constexpr void operator()(T* pointer) {
         delete[] pointer;
     }
 };
 
 // Primary template
 template <typename T, typename Deleter = Slug<T>>
-class UniquePtr {
+class TRIVIAL_ABI UniquePtr {
 public:
     template <typename S, typename S_Deleter>
     friend class UniquePtr;
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Constructors
 
-    explicit UniquePtr(T* ptr = nullptr) : self_(ptr, Deleter{}) {
+    constexpr explicit UniquePtr(T* ptr = nullptr) : self_(ptr, Deleter{}) {
     }
-    UniquePtr(T* ptr, Deleter deleter) : self_(ptr, std::forward<Deleter>(deleter)) {
+    constexpr UniquePtr(T* ptr, Deleter deleter) : self_(ptr, std::forward<Deleter>(deleter)) {
     }
 
-    UniquePtr(UniquePtr&& other) noexcept {
-        self_ = CompressedPair<T*, Deleter>(other.self_.GetFirst(),
-                                            std::forward<Deleter>(other.self_.GetSecond()));
-        other.self_.GetFirst() = nullptr;
+    constexpr UniquePtr(UniquePtr&& other) noexcept(std::is_nothrow_move_constructible_v<Deleter>)
+        : self_(other.Release(), std::forward<Deleter>(other.self_.GetSecond())) {
     }
 
     template <typename S, typename S_Deleter = Deleter>
-    UniquePtr(UniquePtr<S, S_Deleter>&& other) {
-        self_ = CompressedPair<T*, Deleter>(other.self_.GetFirst(),
-                                            std::forward<S_Deleter>(other.self_.GetSecond()));
-        self_.GetFirst() = other.self_.GetFirst();
-        other.self_.GetFirst() = nullptr;
+    constexpr UniquePtr(UniquePtr<S, S_Deleter>&& other) noexcept(
+        std::is_nothrow_constructible_v<Deleter, S_Deleter&&>)
+        : self_(other.Release(), std::forward<S_Deleter>(other.self_.GetSecond())) {
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // `operator=`-s
 
-    UniquePtr& operator=(UniquePtr&& other) noexcept {
+    constexpr UniquePtr& operator=(UniquePtr&& other) noexcept(
+        std::is_nothrow_move_assignable_v<Deleter>) {
         if (this == &other) {
             return *this;
         }
@@ -73,7 +75,7 @@ public:
         return *this;
     }
 
-    UniquePtr& operator=(std::nullptr_t) noexcept {
+    constexpr UniquePtr& operator=(std::nullptr_t) noexcept {
         self_.GetSecond()(self_.GetFirst());
         self_.GetFirst() = nullptr;
         return *this;
@@ -82,20 +84,20 @@ public:
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Destructor
 
-    ~UniquePtr() {
+    constexpr ~UniquePtr() {
         self_.GetSecond()(self_.GetFirst());
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Modifiers
 
-    T* Release() {
+    constexpr T* Release() noexcept {
         auto temp = self_.GetFirst();
         self_.GetFirst() = nullptr;
         return temp;
     }
 
-    void Reset(T* ptr = nullptr) {
+    constexpr void Reset(T* ptr = nullptr) {
         auto temp = self_.GetFirst();
         self_.GetFirst() = ptr;
         if (temp) {
@@ -103,7 +105,7 @@ public:
         }
     }
 
-    void Swap(UniquePtr& other) {
+    constexpr void Swap(UniquePtr& other) noexcept(std::is_nothrow_swappable_v<Deleter>) {
         std::swap(self_.GetFirst(), other.self_.GetFirst());
         std::swap(self_.GetSecond(), other.self_.GetSecond());
     }
@@ -111,19 +113,19 @@ public:
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Observers
 
-    T* Get() const {
+    constexpr T* Get() const {
         return self_.GetFirst();
     }
 
-    Deleter& GetDeleter() {
+    constexpr Deleter& GetDeleter() {
         return self_.GetSecond();
     }
 
-    const Deleter& GetDeleter() const {
+    constexpr const Deleter& GetDeleter() const {
         return self_.GetSecond();
     }
 
-    explicit operator bool() const {
+    constexpr explicit operator bool() const {
         if (self_.GetFirst()) {
             return true;
         }
@@ -133,11 +135,11 @@ public:
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Single-object dereference operators
 
-    std::add_lvalue_reference_t<T> operator*() const {
+    constexpr std::add_lvalue_reference_t<T> operator*() const {
         return *self_.GetFirst();
     }
 
-    T* operator->() const {
+    constexpr T* operator->() const {
         return self_.GetFirst();
     }
 
@@ -147,26 +149,25 @@ private:
 
 // Specialization for arrays
 template <typename T, typename Deleter>
-class UniquePtr<T[], Deleter> {
+class TRIVIAL_ABI UniquePtr<T[], Deleter> {
 public:
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Constructors
 
-    explicit UniquePtr(T* ptr = nullptr) : self_(ptr, Deleter{}) {
+    constexpr explicit UniquePtr(T* ptr = nullptr) : self_(ptr, Deleter{}) {
     }
-    UniquePtr(T* ptr, Deleter deleter) : self_(ptr, std::forward<Deleter>(deleter)) {
+    constexpr UniquePtr(T* ptr, Deleter deleter) : self_(ptr, std::forward<Deleter>(deleter)) {
     }
 
-    UniquePtr(UniquePtr&& other) noexcept {
-        self_ = CompressedPair<T*, Deleter>(other.self_.GetFirst(),
-                                            std::forward<Deleter>(other.self_.GetSecond()));
-        other.self_.GetFirst() = nullptr;
+    constexpr UniquePtr(UniquePtr&& other) noexcept(std::is_nothrow_move_constructible_v<Deleter>)
+        : self_(other.Release(), std::forward<Deleter>(other.self_.GetSecond())) {
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // `operator=`-s
 
-    UniquePtr& operator=(UniquePtr&& other) noexcept {
+    constexpr UniquePtr& operator=(UniquePtr&& other) noexcept(
+        std::is_nothrow_move_assignable_v<Deleter>) {
         if (this == &other) {
             return *this;
         }
@@ -177,7 +178,7 @@ public:
         return *this;
     }
 
-    UniquePtr& operator=(std::nullptr_t) noexcept {
+    constexpr UniquePtr& operator=(std::nullptr_t) noexcept {
         self_.GetSecond()(self_.GetFirst());
         self_.GetFirst() = nullptr;
         return *this;
@@ -186,20 +187,20 @@ public:
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Destructor
 
-    ~UniquePtr() {
+    constexpr ~UniquePtr() {
         self_.GetSecond()(self_.GetFirst());
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Modifiers
 
-    T* Release() {
+    constexpr T* Release() noexcept {
         auto temp = self_.GetFirst();
         self_.GetFirst() = nullptr;
         return temp;
     }
 
-    void Reset(T* ptr = nullptr) {
+    constexpr void Reset(T* ptr = nullptr) {
         auto temp = self_.GetFirst();
         self_.GetFirst() = ptr;
         if (temp) {
@@ -207,7 +208,7 @@ public:
         }
     }
 
-    void Swap(UniquePtr& other) {
+    constexpr void Swap(UniquePtr& other) noexcept(std::is_nothrow_swappable_v<Deleter>) {
         std::swap(self_.GetFirst(), other.self_.GetFirst());
         std::swap(self_.GetSecond(), other.self_.GetSecond());
     }
@@ -215,29 +216,111 @@ public:
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Observers
 
-    T* Get() const {
+    constexpr T* Get() const {
         return self_.GetFirst();
     }
 
-    Deleter& GetDeleter() {
+    constexpr Deleter& GetDeleter() {
         return self_.GetSecond();
     }
 
-    const Deleter& GetDeleter() const {
+    constexpr const Deleter& GetDeleter() const {
         return self_.GetSecond();
     }
 
-    explicit operator bool() const {
+    constexpr explicit operator bool() const {
         if (self_.GetFirst()) {
             return true;
         }
         return false;
     }
 
-    std::add_lvalue_reference_t<T> operator[](size_t pos) {
+    constexpr std::add_lvalue_reference_t<T> operator[](size_t pos) {
         return *(self_.GetFirst() + pos);
     }
 
 private:
     CompressedPair<T*, Deleter> self_;
 };
+
+// Only the pointer and the deleter are stored, so the deleter decides
+template <typename T, typename Deleter>
+struct IsTriviallyRelocatable<UniquePtr<T, Deleter>> : IsTriviallyRelocatable<Deleter> {};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Factories
+
+template <typename T, typename... Args>
+    requires(!std::is_array_v<T>)
+constexpr UniquePtr<T> MakeUnique(Args&&... args) {
+    return UniquePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+// Value-initialized elements (zeroes for trivial types)
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+constexpr UniquePtr<T> MakeUnique(size_t size) {
+    return UniquePtr<T>(new std::remove_extent_t<T>[size]());
+}
+
+template <typename T, typename... Args>
+    requires std::is_bounded_array_v<T>
+void MakeUnique(Args&&... args) = delete;
+
+// Default-initialized object: trivial types are left uninitialized
+template <typename T>
+    requires(!std::is_array_v<T>)
+constexpr UniquePtr<T> MakeUniqueForOverwrite() {
+    return UniquePtr<T>(new T);
+}
+
+// Default-initialized elements, skips zeroing buffers that will be overwritten anyway
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+constexpr UniquePtr<T> MakeUniqueForOverwrite(size_t size) {
+    return UniquePtr<T>(new std::remove_extent_t<T>[size]);
+}
+
+template <typename T, typename... Args>
+    requires std::is_bounded_array_v<T>
+void MakeUniqueForOverwrite(Args&&... args) = delete;
+
+// Returns the object's memory to the arena it came from. `Arena` is any type with
+// `void* Allocate(size_t size, size_t alignment)` and
+// `void Deallocate(void* pointer, size_t size, size_t alignment)`.
+template <typename T, typename Arena>
+class ArenaDeleter {
+public:
+    ArenaDeleter() = default;
+
+    explicit ArenaDeleter(Arena* arena) : arena_(arena) {
+    }
+
+    void operator()(T* pointer) {
+        if (pointer) {
+            pointer->~T();
+            arena_->Deallocate(pointer, sizeof(T), alignof(T));
+        }
+    }
+
+    Arena* GetArena() const {
+        return arena_;
+    }
+
+private:
+    Arena* arena_ = nullptr;
+};
+
+template <typename T, typename Arena, typename... Args>
+    requires(!std::is_array_v<T>)
+UniquePtr<T, ArenaDeleter<T, Arena>> MakeUniqueIn(Arena& arena, Args&&... args) {
+    void* memory = arena.Allocate(sizeof(T), alignof(T));
+    T* object;
+    try {
+        object = new (memory) T(std::forward<Args>(args)...);
+    } catch (...) {
+        arena.Deallocate(memory, sizeof(T), alignof(T));
+        throw;
+    }
+    return UniquePtr<T, ArenaDeleter<T, Arena>>(object, ArenaDeleter<T, Arena>(&arena));
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "unique.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+// Type-erased owner of a single heap object. Instead of a stateful deleter
+// (which would make `UniquePtr<void, std::function<...>>` several words and
+// allocate on its own) it keeps one pointer to a static per-type table, so
+// the handle is always two words.
+
+namespace detail {
+
+struct AnyTypeInfo {
+    void (*destroy)(void* object) noexcept;
+    size_t size;
+    size_t alignment;
+    const std::type_info* type;
+};
+
+template <typename T>
+void DestroyAny(void* object) noexcept {
+    delete static_cast<T*>(object);
+}
+
+template <typename T>
+inline constexpr AnyTypeInfo kAnyTypeInfo{&DestroyAny<T>, sizeof(T), alignof(T), &typeid(T)};
+
+}  // namespace detail
+
+class UniqueAny {
+public:
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Constructors
+
+    UniqueAny() = default;
+
+    UniqueAny(std::nullptr_t) {
+    }
+
+    // Takes over an object owned with the default deleter. Its dynamic type is
+    // forgotten: `Get<S>()` is the only checked way back.
+    template <typename S>
+        requires(!std::is_array_v<S> && !std::is_void_v<S>)
+    UniqueAny(UniquePtr<S>&& other) noexcept
+        : ptr_(const_cast<std::remove_cv_t<S>*>(other.Get())),
+          info_(ptr_ ? &detail::kAnyTypeInfo<std::remove_cv_t<S>> : nullptr) {
+        other.Release();
+    }
+
+    UniqueAny(UniqueAny&& other) noexcept
+        : ptr_(std::exchange(other.ptr_, nullptr)), info_(std::exchange(other.info_, nullptr)) {
+    }
+
+    UniqueAny(const UniqueAny&) = delete;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // `operator=`-s
+
+    UniqueAny& operator=(UniqueAny&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        Reset();
+        ptr_ = std::exchange(other.ptr_, nullptr);
+        info_ = std::exchange(other.info_, nullptr);
+        return *this;
+    }
+
+    UniqueAny& operator=(std::nullptr_t) noexcept {
+        Reset();
+        return *this;
+    }
+
+    UniqueAny& operator=(const UniqueAny&) = delete;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Destructor
+
+    ~UniqueAny() {
+        Reset();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    void Reset() noexcept {
+        if (ptr_) {
+            info_->destroy(ptr_);
+            ptr_ = nullptr;
+            info_ = nullptr;
+        }
+    }
+
+    // Hands the object back if it is a `T`, otherwise keeps it and returns an
+    // empty pointer
+    template <typename T>
+    UniquePtr<T> Release() {
+        T* object = Get<T>();
+        if (object) {
+            ptr_ = nullptr;
+            info_ = nullptr;
+        }
+        return UniquePtr<T>(object);
+    }
+
+    void Swap(UniqueAny& other) noexcept {
+        std::swap(ptr_, other.ptr_);
+        std::swap(info_, other.info_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    void* Get() const {
+        return ptr_;
+    }
+
+    // Checked downcast: null unless the object's type is exactly `T`
+    template <typename T>
+    T* Get() const {
+        return Is<T>() ? static_cast<T*>(ptr_) : nullptr;
+    }
+
+    template <typename T>
+    bool Is() const {
+        using U = std::remove_cv_t<T>;
+        if (info_ == &detail::kAnyTypeInfo<U>) {
+            return true;
+        }
+        // Tables may be duplicated across shared libraries
+        return info_ && *info_->type == typeid(U);
+    }
+
+    // `typeid(void)` when empty
+    const std::type_info& Type() const {
+        return info_ ? *info_->type : typeid(void);
+    }
+
+    // Size and alignment of the owned object, 0 when empty
+    size_t Size() const {
+        return info_ ? info_->size : 0;
+    }
+
+    size_t Alignment() const {
+        return info_ ? info_->alignment : 0;
+    }
+
+    explicit operator bool() const {
+        return ptr_ != nullptr;
+    }
+
+private:
+    void* ptr_ = nullptr;
+    const detail::AnyTypeInfo* info_ = nullptr;
+};
+
+template <typename T, typename... Args>
+    requires(!std::is_array_v<T>)
+UniqueAny MakeUniqueAny(Args&&... args) {
+    return UniqueAny(MakeUnique<T>(std::forward<Args>(args)...));
+}
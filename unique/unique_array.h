@@ -0,0 +1,178 @@
+#pragma once
+
+#include "unique.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>  // std::uninitialized_*_construct_n
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Frees storage from `MakeAlignedUniqueArray*`. Elements are not destroyed,
+// so only trivially destructible types (SIMD buffers and the like) qualify.
+template <typename T, size_t Alignment>
+struct AlignedArrayDeleter {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Aligned arrays are for trivially destructible types");
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two not less than alignof(T)");
+
+    void operator()(T* pointer) {
+        ::operator delete[](pointer, std::align_val_t(Alignment));
+    }
+};
+
+// `UniquePtr<T[], Deleter>` that knows its length
+template <typename T, typename Deleter = Slug<T[]>>
+class UniqueArray {
+public:
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Constructors
+
+    UniqueArray() : size_(0) {
+    }
+
+    UniqueArray(UniquePtr<T[], Deleter> data, size_t size) : data_(std::move(data)), size_(size) {
+    }
+
+    UniqueArray(UniqueArray&& other) noexcept(
+        std::is_nothrow_move_constructible_v<UniquePtr<T[], Deleter>>)
+        : data_(std::move(other.data_)), size_(std::exchange(other.size_, 0)) {
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // `operator=`-s
+
+    UniqueArray& operator=(UniqueArray&& other) noexcept(
+        std::is_nothrow_move_assignable_v<UniquePtr<T[], Deleter>>) {
+        if (this == &other) {
+            return *this;
+        }
+        data_ = std::move(other.data_);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    UniquePtr<T[], Deleter> Release() {
+        size_ = 0;
+        return std::move(data_);
+    }
+
+    void Reset() {
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    void Swap(UniqueArray& other) {
+        data_.Swap(other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    T* Get() const {
+        return data_.Get();
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    T& operator[](size_t pos) const {
+        return Get()[pos];
+    }
+
+    // Bounds-checked access
+    T& At(size_t pos) const {
+        if (pos >= size_) {
+            throw std::out_of_range("UniqueArray::At");
+        }
+        return Get()[pos];
+    }
+
+    T* begin() const {
+        return Get();
+    }
+
+    T* end() const {
+        return Get() + size_;
+    }
+
+    std::span<T> AsSpan() const {
+        return {Get(), size_};
+    }
+
+    operator std::span<T>() const {
+        return AsSpan();
+    }
+
+    operator std::span<const T>() const {
+        return AsSpan();
+    }
+
+    explicit operator bool() const {
+        return static_cast<bool>(data_);
+    }
+
+private:
+    UniquePtr<T[], Deleter> data_;
+    size_t size_;
+};
+
+template <typename T, size_t Alignment>
+using AlignedUniqueArray = UniqueArray<T, AlignedArrayDeleter<T, Alignment>>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Factories
+
+// Value-initialized elements
+template <typename T>
+UniqueArray<T> MakeUniqueArray(size_t size) {
+    return UniqueArray<T>(MakeUnique<T[]>(size), size);
+}
+
+// Default-initialized elements: no zero-fill for trivial types
+template <typename T>
+UniqueArray<T> MakeUniqueArrayForOverwrite(size_t size) {
+    return UniqueArray<T>(MakeUniqueForOverwrite<T[]>(size), size);
+}
+
+namespace detail {
+
+// Throws `std::bad_array_new_length` when the byte count overflows, like `new T[size]`
+template <typename T, size_t Alignment>
+T* AllocateAligned(size_t size) {
+    if (size > SIZE_MAX / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(::operator new[](size * sizeof(T), std::align_val_t(Alignment)));
+}
+
+}  // namespace detail
+
+template <typename T, size_t Alignment>
+AlignedUniqueArray<T, Alignment> MakeAlignedUniqueArray(size_t size) {
+    UniquePtr<T[], AlignedArrayDeleter<T, Alignment>> data(
+        detail::AllocateAligned<T, Alignment>(size));
+    std::uninitialized_value_construct_n(data.Get(), size);
+    return AlignedUniqueArray<T, Alignment>(std::move(data), size);
+}
+
+template <typename T, size_t Alignment>
+AlignedUniqueArray<T, Alignment> MakeAlignedUniqueArrayForOverwrite(size_t size) {
+    UniquePtr<T[], AlignedArrayDeleter<T, Alignment>> data(
+        detail::AllocateAligned<T, Alignment>(size));
+    std::uninitialized_default_construct_n(data.Get(), size);
+    return AlignedUniqueArray<T, Alignment>(std::move(data), size);
+}
@@ -2,6 +2,7 @@
 #include "weak.h"
 
 #include <common/my_int.h>
+#include <common/relocating_vector.h>
 
 #include <catch.hpp>
 
@@ -169,3 +170,18 @@ TEST_CASE("Lifetimes") {
     }
 
 }
+
+TEST_CASE("Trivial relocation") {
+    static_assert(kIsTriviallyRelocatable<WeakPtr<int>>);
+
+    RelocatingVector<WeakPtr<int>> v;
+    auto value = MakeShared<int>(42);
+    for (int i = 0; i < 1000; ++i) {
+        v.EmplaceBack(value);
+    }
+    for (auto& ptr : v) {
+        REQUIRE(*ptr.Lock() == 42);
+    }
+    value.Reset();
+    REQUIRE(v[0].Expired());
+}